@@ -0,0 +1,49 @@
+#include <random>
+#include "benchmark/benchmark.h"
+#include "core/bitboard.hpp"
+
+// Pawn-like bitboards, 8 pawns on average
+static std::vector<Bitboard> random_pawn_bitboards() {
+    std::mt19937_64 rng(42);
+    std::vector<Bitboard> bitboards(1024);
+    for (Bitboard& bb : bitboards)
+        bb = rng() & rng() & rng() & 0x00FFFFFFFFFFFF00ULL;
+    return bitboards;
+}
+
+// Previous per-pawn table loop implementation
+static Bitboard table_fill(Bitboard bb, const Bitboard (&table)[64]) {
+    Bitboard fill = 0ULL;
+    while (bb) {
+        fill |= table[+lsb(bb)];
+        pop_lsb(bb);
+    }
+    return fill;
+}
+
+// Front and rear spans for both colors and both file fills, as used by the pawn evaluation
+static void BM_span_fills(benchmark::State& state) {
+    const bool shift_fills = state.range(0) != 0;
+    const std::vector<Bitboard> bitboards = random_pawn_bitboards();
+
+    for (auto _ : state) {
+        Bitboard acc = 0ULL;
+        for (Bitboard bb : bitboards) {
+            if (shift_fills) {
+                acc ^= front_spans<Color::White>(bb) ^ front_spans<Color::Black>(bb);
+                acc ^= rear_spans<Color::White>(bb) ^ rear_spans<Color::Black>(bb);
+                acc ^= left_attack_file_fills(bb) ^ right_attack_file_fills(bb);
+            }
+            else {
+                acc ^= table_fill(bb, FRONT_SPAN[+Color::White]) ^ table_fill(bb, FRONT_SPAN[+Color::Black]);
+                acc ^= table_fill(bb, REAR_SPAN[+Color::White]) ^ table_fill(bb, REAR_SPAN[+Color::Black]);
+                acc ^= table_fill(bb, LEFT_ATTACK_FILE_FILL) ^ table_fill(bb, RIGHT_ATTACK_FILE_FILL);
+            }
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(bitboards.size()));
+}
+
+// 0 = per-pawn table loops, 1 = shift based fills
+BENCHMARK(BM_span_fills)->Arg(0)->Arg(1);
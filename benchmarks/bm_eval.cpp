@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include "benchmark/benchmark.h"
+#include "core/move_generation.hpp"
+#include "engine/search_position.hpp"
+
+static const std::vector<FEN> EVAL_TEST_POSITIONS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/bp4pp/2p2nn1/p2p4/3P2b1/4BNN1/PP2BPPP/R2QR1K1 w - - 0 19",
+    "r4r2/4qppk/2pp3p/b1n1p2P/PR2P1Q1/1BN5/2P2PP1/3R2K1 w - - 2 29",
+    "8/pp1rkn2/2p1p3/2P2pp1/1B6/4bPP1/PPB1P1K1/7R b - - 3 31",
+};
+
+// Full static evaluation cost per call, over the children of a few positions.
+// Pawn and material entries stay cached as in search, the eval cache is bypassed.
+static void BM_eval(benchmark::State& state) {
+    const bool static_features = state.range(0) != 0;
+
+    // SearchPosition is not movable, so keep it behind a pointer
+    std::vector<std::unique_ptr<SearchPosition>> positions;
+    std::vector<MoveList> move_lists(EVAL_TEST_POSITIONS.size());
+    for (size_t i = 0; i < EVAL_TEST_POSITIONS.size(); ++i) {
+        positions.push_back(std::make_unique<SearchPosition>(1));
+        positions[i]->set_board(EVAL_TEST_POSITIONS[i]);
+        move_lists[i].generate<GenerateType::Legal>(positions[i]->get_position());
+    }
+
+    uint64_t evals = 0;
+    int64_t checksum = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            for (Move move : move_lists[i]) {
+                positions[i]->make_move(move);
+                positions[i]->set_static_features(static_features); // also clears the eval cache in O(1)
+                checksum += positions[i]->get_eval();
+                positions[i]->undo_move();
+            }
+            evals += move_lists[i].count();
+        }
+    }
+    benchmark::DoNotOptimize(checksum);
+    state.counters["time_per_eval"] = benchmark::Counter(static_cast<double>(evals),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// 0 = without static features (previous default), 1 = with outposts, king safety and mobility
+BENCHMARK(BM_eval)->Arg(0)->Arg(1);
+
+// Opponent king zone of the static features: king square, its neighbours and two more squares forward
+static Bitboard king_zone(const Position& position, Color side) {
+    const Square opp_king_square = lsb(position.get_pieces(opponent(side), PieceType::King));
+    const Bitboard zone = MASK_KING_ATTACKS[+opp_king_square] | MASK_SQUARE[+opp_king_square];
+    return zone | (side == Color::White ? shift_bb<Shift::DoubleDown>(zone) : shift_bb<Shift::DoubleUp>(zone));
+}
+
+// Previous mobility and king attack loops, one copy per piece type with mg/eg kept apart.
+// The attack count and multiplier fixes are applied so that both versions give the same score.
+static Score old_piece_attacks(const Position& position) {
+    Score eval = Score::Zero;
+    for (Color side : {Color::White, Color::Black}) {
+        const Bitboard all_own_pieces = position.get_pieces(side);
+        const int32_t sign = (side == Color::White) ? 1 : -1;
+        const Bitboard opp_king_zone = king_zone(position, side);
+        int32_t attack_value_mg = 0, attack_value_eg = 0, attack_count = 0;
+
+        // Knights
+        Bitboard knights = position.get_pieces(side, PieceType::Knight);
+        while (knights) {
+            Square sq = lsb(knights);
+            Bitboard attacks = MASK_KNIGHT_ATTACKS[+sq] & ~all_own_pieces;
+
+            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
+            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Knight][+GamePhase::Middlegame];
+            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Knight][+GamePhase::Endgame];
+            attack_count += king_zone_attacks > 0;
+
+            int32_t mob = popcount(attacks);
+            eval += sign * mob * make_score(MOBILITY_VALUES[+PieceType::Knight][+GamePhase::Middlegame],
+                                            MOBILITY_VALUES[+PieceType::Knight][+GamePhase::Endgame]);
+            pop_lsb(knights);
+        }
+
+        // Bishop
+        Bitboard bishops = position.get_pieces(side, PieceType::Bishop);
+        while (bishops) {
+            Square sq = lsb(bishops);
+            Bitboard attacks = attacks_from<PieceType::Bishop>(sq, position.get_pieces()) & ~all_own_pieces;
+
+            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
+            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Bishop][+GamePhase::Middlegame];
+            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Bishop][+GamePhase::Endgame];
+            attack_count += king_zone_attacks > 0;
+
+            int32_t mob = popcount(attacks);
+            eval += sign * mob * make_score(MOBILITY_VALUES[+PieceType::Bishop][+GamePhase::Middlegame],
+                                            MOBILITY_VALUES[+PieceType::Bishop][+GamePhase::Endgame]);
+            pop_lsb(bishops);
+        }
+
+        // Rook
+        Bitboard rooks = position.get_pieces(side, PieceType::Rook);
+        while (rooks) {
+            Square sq = lsb(rooks);
+            Bitboard attacks = attacks_from<PieceType::Rook>(sq, position.get_pieces()) & ~all_own_pieces;
+
+            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
+            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Rook][+GamePhase::Middlegame];
+            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Rook][+GamePhase::Endgame];
+            attack_count += king_zone_attacks > 0;
+
+            int32_t mob = popcount(attacks);
+            eval += sign * mob * make_score(MOBILITY_VALUES[+PieceType::Rook][+GamePhase::Middlegame],
+                                            MOBILITY_VALUES[+PieceType::Rook][+GamePhase::Endgame]);
+            pop_lsb(rooks);
+        }
+
+        // Queen
+        Bitboard queens = position.get_pieces(side, PieceType::Queen);
+        while (queens) {
+            Square sq = lsb(queens);
+            Bitboard attacks = attacks_from<PieceType::Queen>(sq, position.get_pieces()) & ~all_own_pieces;
+
+            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
+            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Queen][+GamePhase::Middlegame];
+            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Queen][+GamePhase::Endgame];
+            attack_count += king_zone_attacks > 0;
+
+            int32_t mob = popcount(attacks);
+            eval += sign * mob * make_score(MOBILITY_VALUES[+PieceType::Queen][+GamePhase::Middlegame],
+                                            MOBILITY_VALUES[+PieceType::Queen][+GamePhase::Endgame]);
+            pop_lsb(queens);
+        }
+
+        // Final king safety adjustment
+        const int32_t multiplier = ATTACK_COUNT_MULTIPLIER[std::min(attack_count, 6)];
+        eval += sign * make_score(attack_value_mg * multiplier / 100, attack_value_eg * multiplier / 100);
+    }
+    return eval;
+}
+
+// Same as SearchPosition::_eval_piece_attacks(), which is private
+template<PieceType type>
+static Score piece_attacks(const Position& position, Color side, Bitboard occupied, Bitboard mobility_area, Bitboard king_zone,
+                           Score& attack_value, int32_t& attack_count) {
+    int32_t mobility = 0, king_zone_attacks = 0;
+    Bitboard pieces = position.get_pieces(side, type);
+    while (pieces) {
+        const Bitboard attacks = attacks_from<type>(lsb(pieces), occupied);
+        const int32_t zone_attacks = popcount(attacks & king_zone);
+        mobility += popcount(attacks & mobility_area);
+        king_zone_attacks += zone_attacks;
+        attack_count += zone_attacks > 0;
+        pop_lsb(pieces);
+    }
+
+    attack_value += king_zone_attacks * make_score(ATTACK_VALUES[+type][+GamePhase::Middlegame],
+                                                   ATTACK_VALUES[+type][+GamePhase::Endgame]);
+    return mobility * make_score(MOBILITY_VALUES[+type][+GamePhase::Middlegame],
+                                 MOBILITY_VALUES[+type][+GamePhase::Endgame]);
+}
+
+// Current mobility and king attack part of SearchPosition::_eval_static_features()
+static Score new_piece_attacks(const Position& position) {
+    Score eval = Score::Zero;
+    const Bitboard occupied = position.get_pieces();
+    for (Color side : {Color::White, Color::Black}) {
+        const int32_t sign = (side == Color::White) ? 1 : -1;
+        const Bitboard mobility_area = ~position.get_pieces(side);
+        const Bitboard opp_king_zone = king_zone(position, side) & mobility_area;
+
+        Score attack_value = Score::Zero;
+        int32_t attack_count = 0;
+        Score side_eval = piece_attacks<PieceType::Knight>(position, side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+        side_eval += piece_attacks<PieceType::Bishop>(position, side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+        side_eval += piece_attacks<PieceType::Rook>(position, side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+        side_eval += piece_attacks<PieceType::Queen>(position, side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+
+        const int32_t multiplier = ATTACK_COUNT_MULTIPLIER[std::min(attack_count, 6)];
+        side_eval += make_score(mg_value(attack_value) * multiplier / 100, eg_value(attack_value) * multiplier / 100);
+
+        eval += sign * side_eval;
+    }
+    return eval;
+}
+
+// Mobility and king attack cost per position, over the children of the test positions.
+// Children are set up beforehand, so only the attack loops are timed.
+static void BM_eval_piece_attacks(benchmark::State& state) {
+    const bool new_loop = state.range(0) != 0;
+
+    std::vector<std::unique_ptr<Position>> positions;
+    for (const FEN& fen : EVAL_TEST_POSITIONS) {
+        Position parent(fen);
+        MoveList move_list;
+        move_list.generate<GenerateType::Legal>(parent);
+        for (Move move : move_list) {
+            parent.make_move(move);
+            positions.push_back(std::make_unique<Position>(parent, false));
+            parent.undo_move();
+        }
+    }
+
+    // Both versions must agree, otherwise the comparison is meaningless
+    for (const auto& position : positions) {
+        if (old_piece_attacks(*position) != new_piece_attacks(*position)) {
+            state.SkipWithError("old and new attack loops disagree");
+            return;
+        }
+    }
+
+    Score checksum = Score::Zero;
+    for (auto _ : state) {
+        for (const auto& position : positions)
+            checksum += new_loop ? new_piece_attacks(*position) : old_piece_attacks(*position);
+    }
+    benchmark::DoNotOptimize(checksum);
+    state.counters["time_per_eval"] = benchmark::Counter(static_cast<double>(state.iterations() * positions.size()),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// 0 = previous per-piece-type copied loops, 1 = templated helper used by SearchPosition
+BENCHMARK(BM_eval_piece_attacks)->Arg(0)->Arg(1);
+
+// NNUE evaluation cost per call, including the incremental accumulator update of make_move().
+// Uses a random network, inference cost does not depend on the weights.
+static void BM_eval_nnue(benchmark::State& state) {
+    auto network = std::make_shared<NnueNetwork>();
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> dist(-64, 64);
+    for (auto& row : network->feature_weights)
+        for (int16_t& w : row) w = static_cast<int16_t>(dist(rng));
+    for (int16_t& b : network->feature_biases) b = static_cast<int16_t>(dist(rng) + 64);
+    for (auto& row : network->output_weights)
+        for (int16_t& w : row) w = static_cast<int16_t>(dist(rng));
+    network->output_bias = 0;
+
+    std::vector<std::unique_ptr<SearchPosition>> positions;
+    std::vector<MoveList> move_lists(EVAL_TEST_POSITIONS.size());
+    for (size_t i = 0; i < EVAL_TEST_POSITIONS.size(); ++i) {
+        positions.push_back(std::make_unique<SearchPosition>(1));
+        positions[i]->set_nnue(network);
+        positions[i]->set_board(EVAL_TEST_POSITIONS[i]);
+        move_lists[i].generate<GenerateType::Legal>(positions[i]->get_position());
+    }
+
+    uint64_t evals = 0;
+    int64_t checksum = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            for (Move move : move_lists[i]) {
+                positions[i]->make_move(move);
+                positions[i]->set_static_features(true); // clears the eval cache in O(1)
+                checksum += positions[i]->get_eval();
+                positions[i]->undo_move();
+            }
+            evals += move_lists[i].count();
+        }
+    }
+    benchmark::DoNotOptimize(checksum);
+    state.counters["time_per_eval"] = benchmark::Counter(static_cast<double>(evals),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_eval_nnue);
@@ -1,6 +1,8 @@
+#include <memory>
 #include "benchmark/benchmark.h"
 #include "core/position.hpp"
 #include "core/move_generation.hpp"
+#include "engine/search_position.hpp"
 
 const FEN CHESS_START_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
@@ -33,4 +35,49 @@ static void BM_perft(benchmark::State& state) {
     }
 }
 
-BENCHMARK(BM_perft)->Arg(3)->Arg(4)->Arg(5)->Arg(6)->Arg(7)->Unit(benchmark::kMillisecond);
\ No newline at end of file
+BENCHMARK(BM_perft)->Arg(3)->Arg(4)->Arg(5)->Arg(6)->Arg(7)->Unit(benchmark::kMillisecond);
+
+// Make and undo every legal move of a few positions, without move generation in the loop.
+// Measures the incremental board and evaluation updates.
+static void BM_make_undo(benchmark::State& state) {
+    const std::vector<FEN> positions = {
+        CHESS_START_POSITION,
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    const bool with_eval = state.range(0) != 0;
+
+    // Neither class is movable, so keep them behind pointers
+    std::vector<std::unique_ptr<SearchPosition>> search_positions;
+    std::vector<std::unique_ptr<Position>> plain_positions;
+    std::vector<MoveList> move_lists(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        search_positions.push_back(std::make_unique<SearchPosition>(1));
+        search_positions[i]->set_board(positions[i]);
+        plain_positions.push_back(std::make_unique<Position>(positions[i]));
+        move_lists[i].generate<GenerateType::Legal>(*plain_positions[i]);
+    }
+
+    uint64_t moves = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            for (Move move : move_lists[i]) {
+                if (with_eval) {
+                    search_positions[i]->make_move(move);
+                    search_positions[i]->undo_move();
+                }
+                else {
+                    plain_positions[i]->make_move(move);
+                    plain_positions[i]->undo_move();
+                }
+            }
+            moves += move_lists[i].count();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.counters["moves_per_second"] = benchmark::Counter(static_cast<double>(moves), benchmark::Counter::kIsRate);
+}
+
+// 0 = Position only, 1 = SearchPosition (with incremental evaluation)
+BENCHMARK(BM_make_undo)->Arg(0)->Arg(1);
@@ -1,26 +1,42 @@
 #include "benchmark/benchmark.h"
 #include "engine/minimax_engine.hpp"
 
-static void run_minimax_fixed_depth(benchmark::State& state,
-                                    const std::vector<FEN>& positions,
-                                    const int depth,
-                                    const size_t tt_size_megabytes)
+// Returns the alpha-beta and quiescence nodes searched in the last iteration
+static uint64_t run_minimax_fixed_depth(benchmark::State& state,
+                                        const std::vector<FEN>& positions,
+                                        const int depth,
+                                        const size_t tt_size_megabytes,
+                                        const SearchParameters& params = SearchParameters())
 {
+    uint64_t total_nodes = 0;
     for (auto _ : state) {
         uint64_t total_alpha_beta_nodes = 0;
         uint64_t total_quiescence_nodes = 0;
         uint64_t total_aspiration_miss_nodes = 0;
+        uint64_t total_tt_raw_hits = 0;
+        uint64_t total_eval_calls = 0;
+        uint64_t total_tt_eval_hits = 0;
+        uint64_t total_eval_cache_hits = 0;
+        uint64_t total_eval_cache_probes = 0;
+        double total_time_seconds = 0.0;
         uint64_t total_eval = 0; // for verification
 
         // Fixed-depth search with unlimited time, so that we can compare pruning stats (same game tree)
         for (const FEN& fen : positions) {
             MinimaxAI ai(depth, 1e6, tt_size_megabytes, false);
+            ai.set_search_parameters(params);
             ai.set_board(fen);
             ai.compute_move();
             MinimaxAI::Stats s = ai.get_stats();
             total_alpha_beta_nodes += s.alpha_beta_nodes;
             total_quiescence_nodes += s.quiescence_nodes;
             total_aspiration_miss_nodes += s.aspiration_miss_nodes;
+            total_tt_raw_hits += s.tt_raw_hits;
+            total_eval_calls += s.eval_calls;
+            total_tt_eval_hits += s.tt_eval_hits;
+            total_eval_cache_hits += s.eval_cache_hits;
+            total_eval_cache_probes += s.eval_cache_hits + s.eval_cache_misses;
+            total_time_seconds += s.time_seconds;
             total_eval += s.eval;
         }
 
@@ -28,8 +44,15 @@ static void run_minimax_fixed_depth(benchmark::State& state,
         state.counters["alpha_beta_nodes_avg"] = static_cast<double>(total_alpha_beta_nodes) / n;
         state.counters["quiescence_nodes_avg"] = static_cast<double>(total_quiescence_nodes) / n;
         state.counters["aspiration_miss_nodes_avg"] = static_cast<double>(total_aspiration_miss_nodes) / n;
+        state.counters["tt_hit_rate"] = static_cast<double>(total_tt_raw_hits) / static_cast<double>(total_alpha_beta_nodes);
+        state.counters["eval_calls_avg"] = static_cast<double>(total_eval_calls) / n;
+        state.counters["tt_eval_hits_avg"] = static_cast<double>(total_tt_eval_hits) / n;
+        state.counters["eval_cache_hit_rate"] = static_cast<double>(total_eval_cache_hits) / static_cast<double>(total_eval_cache_probes);
+        state.counters["nps"] = static_cast<double>(total_alpha_beta_nodes + total_quiescence_nodes) / total_time_seconds;
         state.counters["eval_verification_sum"] = static_cast<double>(total_eval);
+        total_nodes = total_alpha_beta_nodes + total_quiescence_nodes;
     }
+    return total_nodes;
 }
 
 static const std::vector<FEN> PRUNING_TEST_POSITIONS = {
@@ -52,3 +75,30 @@ static void BM_minimax_pruning_aspiration(benchmark::State& state) {
 BENCHMARK(BM_minimax_pruning_aspiration)
     ->Arg(10)->Arg(20)->Arg(30)->Arg(50)->Arg(100)
     ->Unit(benchmark::kSecond);
+
+// Switches of the selective pruning techniques, Arg(i) turns off the i:th one (Arg(0) keeps all on)
+static const std::vector<int32_t SearchParameters::*> PRUNING_TECHNIQUES = {
+    &SearchParameters::rfp_enabled,
+    &SearchParameters::razoring_enabled,
+    &SearchParameters::lmp_enabled,
+    &SearchParameters::see_quiet_pruning_enabled,
+};
+
+// Benchmark: depth 10, node reduction of each pruning technique against searching without it.
+// Arg(0) runs first and gives the node count with all techniques enabled.
+static void BM_minimax_pruning_techniques(benchmark::State& state) {
+    static uint64_t all_enabled_nodes = 0;
+    const size_t technique = static_cast<size_t>(state.range(0));
+    SearchParameters params;
+    if (technique > 0)
+        params.*PRUNING_TECHNIQUES[technique - 1] = 0;
+
+    const uint64_t nodes = run_minimax_fixed_depth(state, PRUNING_TEST_POSITIONS, /*depth=*/10, /*tt_size_megabytes=*/512, params);
+    if (technique == 0)
+        all_enabled_nodes = nodes;
+    else if (all_enabled_nodes > 0)
+        state.counters["node_reduction"] = 1.0 - static_cast<double>(all_enabled_nodes) / static_cast<double>(nodes);
+}
+BENCHMARK(BM_minimax_pruning_techniques)
+    ->DenseRange(0, static_cast<int>(PRUNING_TECHNIQUES.size()))
+    ->Unit(benchmark::kSecond);
@@ -0,0 +1,64 @@
+#include "benchmark/benchmark.h"
+#include "engine/minimax_engine.hpp"
+
+static const FEN STARTUP_TEST_POSITION = "rnb1kb1r/pp2pppp/2p2n2/q7/3P4/2N2N2/PPP2PPP/R1BQKB1R w KQkq - 0 6";
+
+// Benchmark: engine construction with a given transposition table size (MB)
+static void BM_minimax_construct(benchmark::State& state) {
+    const size_t tt_size_megabytes = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        MinimaxAI ai(10, 1e6, tt_size_megabytes, false);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_minimax_construct)
+    ->Arg(16)->Arg(256)->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmark: engine construction, setting a position and a shallow search (first move latency)
+static void BM_minimax_construct_and_search(benchmark::State& state) {
+    const size_t tt_size_megabytes = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        MinimaxAI ai(4, 1e6, tt_size_megabytes, false);
+        ai.set_board(STARTUP_TEST_POSITION);
+        ai.compute_move();
+    }
+}
+BENCHMARK(BM_minimax_construct_and_search)
+    ->Arg(16)->Arg(256)->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmark: clearing the transposition table of a used engine (ucinewgame)
+static void BM_minimax_clear_transposition_table(benchmark::State& state) {
+    const size_t tt_size_megabytes = static_cast<size_t>(state.range(0));
+    MinimaxAI ai(4, 1e6, tt_size_megabytes, false);
+    ai.set_board(STARTUP_TEST_POSITION);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        ai.compute_move();
+        state.ResumeTiming();
+        ai.clear_transposition_table();
+    }
+}
+BENCHMARK(BM_minimax_clear_transposition_table)
+    ->Arg(16)->Arg(256)->Arg(1024)
+    ->Iterations(50)
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmark: batch analysis, one engine analysing many positions with a shallow search each
+static void BM_minimax_batch_analysis(benchmark::State& state) {
+    MinimaxAI ai(2, 1e6, 256, false);
+
+    for (auto _ : state) {
+        ai.clear_transposition_table();
+        ai.set_board(STARTUP_TEST_POSITION);
+        ai.compute_move();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_minimax_batch_analysis)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,98 @@
+#include "benchmark/benchmark.h"
+#include "engine/minimax_engine.hpp"
+
+struct TacticalPosition {
+    FEN fen;
+    UCI best_move;
+};
+
+// Win At Chess (WAC) suite, positions 1-30 except 22 which has two best moves. The EPD "bm" moves are given in UCI.
+static const std::vector<TacticalPosition> TACTICAL_TEST_POSITIONS = {
+    {"2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - -", "g3g6"},
+    {"8/7p/5k2/5p2/p1p2P2/Pr1pPK2/1P1R3P/8 b - -", "b3b2"},
+    {"5rk1/1ppb3p/p1pb4/6q1/3P1p1r/2P1R2P/PP1BQ1P1/5RKN w - -", "e3g3"},
+    {"r1bq2rk/pp3pbp/2p1p1pQ/7P/3P4/2PB1N2/PP3PPR/2KR4 w - -", "h6h7"},
+    {"5k2/6pp/p1qN4/1p1p4/3P4/2PKP2Q/PP3r2/3R4 b - -", "c6c4"},
+    {"7k/p7/1R5K/6r1/6p1/6P1/8/8 w - -", "b6b7"},
+    {"rnbqkb1r/pppp1ppp/8/4P3/6n1/7P/PPPNPPP1/R1BQKBNR b KQkq -", "g4e3"},
+    {"r4q1k/p2bR1rp/2p2Q1N/5p2/5p2/2P5/PP3PPP/R5K1 w - -", "e7f7"},
+    {"3q1rk1/p4pp1/2pb3p/3p4/6Pr/1PNQ4/P1PB1PP1/4RRK1 b - -", "d6h2"},
+    {"2br2k1/2q3rn/p2NppQ1/2p1P3/Pp5R/4P3/1P3PPP/3R2K1 w - -", "h4h7"},
+    {"r1b1kb1r/3q1ppp/pBp1pn2/8/Np3P2/5B2/PPP3PP/R2Q1RK1 w kq -", "f3c6"},
+    {"4k1r1/2p3r1/1pR1p3/3pP2p/3P2qP/P4N2/1PQ4P/5R1K b - -", "g4f3"},
+    {"5rk1/pp4p1/2n1p2p/2Npq3/2p5/6P1/P3P1BP/R4Q1K w - -", "f1f8"},
+    {"r2rb1k1/pp1q1p1p/2n1p1p1/2bp4/5P2/PP1BPR1Q/1BPN2PP/R5K1 w - -", "h3h7"},
+    {"1R6/1brk2p1/4p2p/p1P1Pp2/P7/6P1/1P4P1/2R3K1 w - -", "b8b7"},
+    {"r4rk1/ppp2ppp/2n5/2bqp3/8/P2PB3/1PP1NPPP/R2Q1RK1 w - -", "e2c3"},
+    {"1k5r/pppbn1pp/4q1r1/1P3p2/2NPp3/1QP5/P4PPP/R1B1R1K1 w - -", "c4e5"},
+    {"R7/P4k2/8/8/8/8/r7/6K1 w - -", "a8h8"},
+    {"r1b2rk1/ppbn1ppp/4p3/1QP4q/3P4/N4N2/5PPP/R1B2RK1 w - -", "c5c6"},
+    {"r2qkb1r/1ppb1ppp/p7/4p3/P1Q1P3/2P5/5PPP/R1B2KNR b kq -", "d7b5"},
+    {"5rk1/1b3p1p/pp3p2/3n1N2/1P6/P1qB1PP1/3Q3P/4R1K1 w - -", "d2h6"},
+    {"r3nrk1/2p2p1p/p1p1b1p1/2NpPq2/3R4/P1N1Q3/1PP2PPP/4R1K1 w - -", "g2g4"},
+    {"6k1/1b1nqpbp/pp4p1/5P2/1PN5/4Q3/P5PP/1B2B1K1 b - -", "g7d4"},
+    {"3R1rk1/8/5Qpp/2p5/2P1p1q1/P3P3/1P2PK2/8 b - -", "g4h4"},
+    {"3r2k1/1p1b1pp1/pq5p/8/3NR3/2PQ3P/PP3PP1/6K1 b - -", "d7f5"},
+    {"7k/pp4np/2p3p1/3pN1q1/3P4/Q7/1r3rPP/2R2RK1 w - -", "a3f8"},
+    {"1r1r2k1/4pp1p/2p1b1p1/p3R3/RqBP4/4P3/1PQ2PPP/6K1 b - -", "b4e1"},
+    {"r2q2k1/pp1rbppp/4pn2/2P5/1P3B2/6P1/P3QPBP/1R3RK1 w - -", "c5c6"},
+    {"1r3r2/4q1kp/b1pp2p1/5p2/pPn1N3/6P1/P3PPBP/2QRR1K1 w - -", "e4d6"},
+};
+
+// Benchmark: share of the suite solved within a node limit
+// Args: singular extensions enabled, node limit
+static void BM_tactics_solve_rate(benchmark::State& state) {
+    SearchParameters params;
+    params.singular_enabled = static_cast<int32_t>(state.range(0));
+    const int64_t max_nodes = state.range(1);
+    const size_t tt_size_megabytes = 64;
+
+    for (auto _ : state) {
+        int solved = 0;
+        for (const TacticalPosition& position : TACTICAL_TEST_POSITIONS) {
+            state.PauseTiming();
+            MinimaxAI ai(99, 1e6, tt_size_megabytes, false);
+            ai.set_search_parameters(params);
+            ai.set_max_nodes(max_nodes);
+            ai.set_board(position.fen);
+            state.ResumeTiming();
+
+            solved += ai.compute_move() == position.best_move;
+        }
+        state.counters["solve_rate"] = static_cast<double>(solved) / static_cast<double>(TACTICAL_TEST_POSITIONS.size());
+    }
+}
+BENCHMARK(BM_tactics_solve_rate)
+    ->ArgsProduct({{0, 1}, {30'000, 300'000, 1'000'000}})
+    ->Unit(benchmark::kSecond);
+
+// Benchmark: time to reach a fixed depth on the suite
+// Args: singular extensions enabled, depth
+static void BM_tactics_time_to_depth(benchmark::State& state) {
+    SearchParameters params;
+    params.singular_enabled = static_cast<int32_t>(state.range(0));
+    const int depth = static_cast<int>(state.range(1));
+    const size_t tt_size_megabytes = 64;
+
+    for (auto _ : state) {
+        uint64_t total_nodes = 0;
+        int solved = 0;
+        for (const TacticalPosition& position : TACTICAL_TEST_POSITIONS) {
+            // Fresh engine (and transposition table) for each position, construction is not timed
+            state.PauseTiming();
+            MinimaxAI ai(depth, 1e6, tt_size_megabytes, false);
+            ai.set_search_parameters(params);
+            ai.set_board(position.fen);
+            state.ResumeTiming();
+
+            solved += ai.compute_move() == position.best_move;
+            MinimaxAI::Stats s = ai.get_stats();
+            total_nodes += s.alpha_beta_nodes + s.quiescence_nodes;
+        }
+        state.counters["nodes_avg"] = static_cast<double>(total_nodes) / static_cast<double>(TACTICAL_TEST_POSITIONS.size());
+        state.counters["solve_rate"] = static_cast<double>(solved) / static_cast<double>(TACTICAL_TEST_POSITIONS.size());
+    }
+}
+BENCHMARK(BM_tactics_time_to_depth)
+    ->ArgsProduct({{0, 1}, {10, 14}})
+    ->Unit(benchmark::kSecond);
@@ -0,0 +1,81 @@
+#include "benchmark/benchmark.h"
+#include "engine/minimax_engine.hpp"
+
+static const std::vector<FEN> SMP_TEST_POSITIONS = {
+    "rnb1kb1r/pp2pppp/2p2n2/q7/3P4/2N2N2/PPP2PPP/R1BQKB1R w KQkq - 0 6",
+    "rnb2rk1/2q2ppp/p4n2/1p1Pp3/3N2P1/b3B3/BPP1QP1P/R2NK2R w KQ - 0 14",
+    "8/pp1rkn2/2p1p3/2P2pp1/1B6/4bPP1/PPB1P1K1/7R b - - 3 31",
+    "r2q1rk1/bp4pp/2p2nn1/p2p4/3P2b1/4BNN1/PP2BPPP/R2QR1K1 w - - 0 19",
+    "r4r2/4qppk/2pp3p/b1n1p2P/PR2P1Q1/1BN5/2P2PP1/3R2K1 w - - 2 29",
+};
+
+// Benchmark: time to reach a fixed depth with N search threads (Lazy SMP)
+static void BM_minimax_time_to_depth(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(0));
+    const int depth = 10;
+    const size_t tt_size_megabytes = 256;
+
+    for (auto _ : state) {
+        uint64_t total_main_nodes = 0;
+        uint64_t total_helper_nodes = 0;
+
+        for (const FEN& fen : SMP_TEST_POSITIONS) {
+            // Fresh engine (and transposition table) for each position, construction is not timed
+            state.PauseTiming();
+            MinimaxAI ai(depth, 1e6, tt_size_megabytes, false);
+            ai.set_threads(threads);
+            ai.set_board(fen);
+            state.ResumeTiming();
+
+            ai.compute_move();
+
+            MinimaxAI::Stats s = ai.get_stats();
+            total_main_nodes += s.alpha_beta_nodes + s.quiescence_nodes;
+            total_helper_nodes += s.helper_nodes;
+        }
+
+        const double n = static_cast<double>(SMP_TEST_POSITIONS.size());
+        state.counters["main_nodes_avg"] = static_cast<double>(total_main_nodes) / n;
+        state.counters["helper_nodes_avg"] = static_cast<double>(total_helper_nodes) / n;
+    }
+}
+BENCHMARK(BM_minimax_time_to_depth)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)
+    ->UseRealTime()
+    ->Unit(benchmark::kSecond);
+
+// Benchmark: search speed (nps over all threads) with and without pinning the helper threads to CPUs
+// Args: thread count, pinning enabled
+static void BM_minimax_nps_pinning(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(0));
+    const bool pin_threads = state.range(1) != 0;
+    const double time_limit_seconds = 2.0;
+    const size_t tt_size_megabytes = 1024;
+
+    for (auto _ : state) {
+        uint64_t total_nodes = 0;
+        double total_time_seconds = 0.0;
+
+        for (const FEN& fen : SMP_TEST_POSITIONS) {
+            state.PauseTiming();
+            MinimaxAI ai(99, time_limit_seconds, tt_size_megabytes, false);
+            ai.set_threads(threads);
+            ai.set_thread_pinning(pin_threads);
+            ai.set_board(fen);
+            state.ResumeTiming();
+
+            ai.compute_move();
+
+            MinimaxAI::Stats s = ai.get_stats();
+            total_nodes += s.alpha_beta_nodes + s.quiescence_nodes + s.helper_nodes;
+            total_time_seconds += s.time_seconds;
+        }
+
+        state.counters["nps"] = static_cast<double>(total_nodes) / total_time_seconds;
+    }
+}
+BENCHMARK(BM_minimax_nps_pinning)
+    ->ArgsProduct({{2, 4, 8, 16}, {0, 1}})
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kSecond);
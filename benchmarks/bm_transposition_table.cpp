@@ -0,0 +1,142 @@
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "engine/transposition_table.hpp"
+
+static TranspositionTable& shared_table() {
+    static TranspositionTable tt(256);
+    return tt;
+}
+
+// Previous single-threaded table: plain 24 byte entries, linear probing over two slots, no atomics.
+// Kept as the baseline for the cost of the key-XOR-data validation.
+class PlainTranspositionTable {
+public:
+    struct Entry {
+        uint64_t key;
+        int32_t score;
+        Move best_move;
+        int16_t depth;
+        Bound bound;
+        uint8_t age;
+    };
+
+    PlainTranspositionTable(size_t megabytes) {
+        const size_t n = megabytes * 1024ULL * 1024ULL / sizeof(Entry);
+        size_t pow2 = 16ULL;
+        while (pow2 * 2 <= n) pow2 *= 2;
+        m_table.resize(pow2);
+        m_mask = pow2 - 1;
+    }
+
+    const Entry* find(uint64_t key) const {
+        size_t idx = key & m_mask;
+        for (size_t i = 0; i < PROBE_WINDOW; ++i) {
+            if (m_table[idx].key == key) return &m_table[idx];
+            if (m_table[idx].key == 0) return nullptr;
+            idx = (idx + 1) & m_mask;
+        }
+        return nullptr;
+    }
+
+    void store(uint64_t key, int32_t score, int16_t depth, Bound bound, Move best_move) {
+        size_t idx = key & m_mask;
+        size_t replace_idx = idx;
+
+        int best_keep_score = std::numeric_limits<int>::max();
+        for (size_t i = 0; i < PROBE_WINDOW; ++i) {
+            const Entry& entry = m_table[idx];
+            if (entry.key == 0 || entry.key == key) { replace_idx = idx; break; }
+
+            // prefer entries with same age and deeper depth
+            const int keep_score = entry.depth + ((entry.age == m_age) ? 100000 : 0);
+            if (keep_score < best_keep_score) {
+                best_keep_score = keep_score;
+                replace_idx = idx;
+            }
+            idx = (idx + 1) & m_mask;
+        }
+        m_table[replace_idx] = {key, score, best_move, depth, bound, m_age};
+    }
+
+private:
+    static constexpr size_t PROBE_WINDOW = 2;
+    std::vector<Entry> m_table;
+    size_t m_mask = 0;
+    uint8_t m_age = 0;
+};
+
+static PlainTranspositionTable& plain_table() {
+    static PlainTranspositionTable tt(256);
+    return tt;
+}
+
+// Benchmark: mixed probe/store throughput of the previous plain table, single-threaded only
+static void BM_tt_probe_store_plain(benchmark::State& state) {
+    PlainTranspositionTable& tt = plain_table();
+    std::mt19937_64 rng(1);
+
+    for (auto _ : state) {
+        const uint64_t key = rng() | 1ULL;
+        auto entry = tt.find(key);
+        if (!entry)
+            tt.store(key, static_cast<int16_t>(key), 5, Bound::Exact, static_cast<Move>(key));
+        benchmark::DoNotOptimize(entry);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tt_probe_store_plain)->UseRealTime();
+
+// Benchmark: probe throughput of the previous plain table
+static void BM_tt_probe_plain(benchmark::State& state) {
+    PlainTranspositionTable& tt = plain_table();
+    std::mt19937_64 rng(1);
+
+    for (auto _ : state) {
+        auto entry = tt.find(rng() | 1ULL);
+        benchmark::DoNotOptimize(entry);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tt_probe_plain)->UseRealTime();
+
+// Benchmark: mixed probe/store throughput on one shared table.
+// Compare Threads(1) with BM_tt_probe_store_plain for the cost of the lock-free validation,
+// higher thread counts show the concurrent throughput.
+static void BM_tt_probe_store(benchmark::State& state) {
+    TranspositionTable& tt = shared_table();
+    std::mt19937_64 rng(state.thread_index() + 1);
+
+    for (auto _ : state) {
+        const uint64_t key = rng() | 1ULL;
+        auto entry = tt.find(key);
+        if (!entry)
+            tt.store(key, static_cast<int16_t>(key), 5, Bound::Exact, static_cast<Move>(key));
+        benchmark::DoNotOptimize(entry);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tt_probe_store)
+    ->Threads(1)->Threads(2)->Threads(4)->Threads(8)
+    ->UseRealTime();
+
+// Benchmark: probe throughput only
+static void BM_tt_probe(benchmark::State& state) {
+    TranspositionTable& tt = shared_table();
+    std::mt19937_64 rng(state.thread_index() + 1);
+
+    for (auto _ : state) {
+        auto entry = tt.find(rng() | 1ULL);
+        benchmark::DoNotOptimize(entry);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tt_probe)
+    ->Threads(1)->Threads(2)->Threads(4)->Threads(8)
+    ->UseRealTime();
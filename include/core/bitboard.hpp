@@ -12,6 +12,7 @@
 #endif
 
 #include "types.hpp"
+#include "memory.hpp"
 
 #if defined(PEXT_ENABLED) && defined(__BMI2__) && (defined(__x86_64__) || defined(__i386__))
 #include <immintrin.h>
@@ -70,7 +71,7 @@ extern API uint64_t ROOK_MAGIC[64];               // [square]
 extern API uint64_t BISHOP_MAGIC[64];             // [square]
 extern API Bitboard MASK_ROOK_MAGIC[64];          // [square]
 extern API Bitboard MASK_BISHOP_MAGIC[64];        // [square]
-extern API Bitboard ROOK_ATTACK_TABLE[64][4096];  // [square][index]
+extern API Bitboard ROOK_ATTACK_TABLE[64][4096];  // [square][index] huge page aligned
 extern API Bitboard BISHOP_ATTACK_TABLE[64][512]; // [square][index]
 
 // Castling masks and flags
@@ -86,6 +87,9 @@ extern API uint64_t ZOBRIST_SIDE;                 // black to move
 // Precalculation function
 void init_bitboards();
 
+// Page backing obtained for the rook attack table (2 MB)
+PageBacking get_attack_table_page_backing();
+
 // -------------------------
 // Bitboard helper functions
 // -------------------------
@@ -126,6 +130,36 @@ constexpr inline Bitboard shift_bb(Bitboard bb) {
     else if constexpr (shift == Shift::DownLeft)   return (bb & ~MASK_FILE[0]) >> 9;
 }
 
+/**
+ * Fill every set bit up or down the board to the edge, ignoring blockers.
+ * @tparam shift Shift::Up or Shift::Down
+ * @param bb Bitboard to fill
+ * @return Bitboard of the filled squares, including the original bits.
+ */
+template<Shift shift>
+constexpr inline Bitboard fill_bb(Bitboard bb) {
+    static_assert(shift == Shift::Up || shift == Shift::Down, "Only vertical fills are supported");
+    if constexpr (shift == Shift::Up) {
+        bb |= bb << 8;
+        bb |= bb << 16;
+        bb |= bb << 32;
+    }
+    else {
+        bb |= bb >> 8;
+        bb |= bb >> 16;
+        bb |= bb >> 32;
+    }
+    return bb;
+}
+
+/**
+ * @param bb Bitboard to fill
+ * @return Bitboard of all files containing a set bit.
+ */
+constexpr inline Bitboard file_fill(Bitboard bb) {
+    return fill_bb<Shift::Up>(bb) | fill_bb<Shift::Down>(bb);
+}
+
 /**
  * Get attack bitboard for a piece from a given square, considering occupied squares.
  * @tparam type of piece (except Pawn)
@@ -198,13 +232,7 @@ inline Bitboard piece_attacks(Bitboard pieces, Bitboard occupied) {
  */
 template<Color side>
 inline Bitboard front_spans(Bitboard pawns) {
-    Bitboard spans = 0ULL;
-    while (pawns) {
-        Square sq = lsb(pawns);
-        spans |= FRONT_SPAN[+side][+sq];
-        pop_lsb(pawns);
-    }
-    return spans;
+    return fill_bb<pawn_dir(side)>(shift_bb<pawn_dir(side)>(pawns));
 }
 
 /**
@@ -215,13 +243,7 @@ inline Bitboard front_spans(Bitboard pawns) {
  */
 template<Color side>
 inline Bitboard rear_spans(Bitboard pawns) {
-    Bitboard spans = 0ULL;
-    while (pawns) {
-        Square sq = lsb(pawns);
-        spans |= REAR_SPAN[+side][+sq];
-        pop_lsb(pawns);
-    }
-    return spans;
+    return fill_bb<pawn_dir(opponent(side))>(pawns);
 }
 
 /**
@@ -266,13 +288,7 @@ inline Bitboard attack_rear_spans(Bitboard pawns) {
  * @return Bitboard of left attack file fills.
  */
 inline Bitboard left_attack_file_fills(Bitboard pawns) {
-    Bitboard fill = 0ULL;
-    while (pawns) {
-        Square sq = lsb(pawns);
-        fill |= LEFT_ATTACK_FILE_FILL[+sq];
-        pop_lsb(pawns);
-    }
-    return fill;
+    return file_fill(shift_bb<Shift::Left>(pawns));
 }
 
 /**
@@ -281,11 +297,5 @@ inline Bitboard left_attack_file_fills(Bitboard pawns) {
  * @return Bitboard of right attack file fills.
  */
 inline Bitboard right_attack_file_fills(Bitboard pawns) {
-    Bitboard fill = 0ULL;
-    while (pawns) {
-        Square sq = lsb(pawns);
-        fill |= RIGHT_ATTACK_FILE_FILL[+sq];
-        pop_lsb(pawns);
-    }
-    return fill;
+    return file_fill(shift_bb<Shift::Right>(pawns));
 }
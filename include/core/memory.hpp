@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Size of a huge page (x86-64 and most ARM64 Linux configurations)
+constexpr size_t HUGE_PAGE_SIZE = 2ULL * 1024ULL * 1024ULL;
+
+// Align a static table to a huge page boundary, so that it can be backed by a single huge page
+#if defined(__linux__)
+    #define HUGE_PAGE_ALIGNED alignas(HUGE_PAGE_SIZE)
+#else
+    #define HUGE_PAGE_ALIGNED
+#endif
+
+// Page backing actually obtained for an allocation
+enum class PageBacking : uint8_t { Normal, TransparentHuge, ExplicitHuge, MappedFile };
+
+/**
+ * @return Human readable name of the page backing.
+ */
+const char* to_string(PageBacking backing);
+
+/**
+ * Allocate zero-initialized memory for a large table, backed by 2 MB huge pages when possible.
+ * On Linux explicit huge pages (MAP_HUGETLB) are tried first, then transparent huge pages (madvise),
+ * then normal pages. On other platforms normal pages are used.
+ * The memory comes from OS zero pages and is not touched, so it is committed only when first written to.
+ * @param bytes size of the allocation
+ * @param backing set to the page backing that was obtained
+ * @return Pointer to the memory, aligned to at least 4096 bytes.
+ * @throw std::bad_alloc if the allocation fails.
+ */
+void* allocate_large_pages(size_t bytes, PageBacking& backing);
+
+/**
+ * Free memory allocated with allocate_large_pages.
+ * @param ptr the pointer (can be nullptr)
+ * @param bytes size of the allocation, as given to allocate_large_pages
+ */
+void free_large_pages(void* ptr, size_t bytes);
+
+/**
+ * Map a range of a file into private copy-on-write memory. Nothing is read up front,
+ * pages are loaded from the file on first access and writes never reach the file.
+ * Falls back to reading the range into an allocation on platforms without mmap.
+ * The result must be freed with free_large_pages, and must not be cleared with clear_large_pages.
+ * @param path path to the file
+ * @param offset offset of the range in the file, must be a multiple of 4096
+ * @param bytes size of the range, the file must be at least offset + bytes long
+ * @return Pointer to the memory, aligned to at least 4096 bytes.
+ * @throw std::runtime_error if the file cannot be mapped.
+ */
+void* map_file_pages(const std::string& path, size_t offset, size_t bytes);
+
+/**
+ * Reset memory allocated with allocate_large_pages to zero.
+ * Where possible the pages are released back to the OS instead of written, and committed again when touched.
+ * @param ptr the pointer
+ * @param bytes size of the allocation, as given to allocate_large_pages
+ * @param thread_count number of threads to split the work between
+ */
+void clear_large_pages(void* ptr, size_t bytes, size_t thread_count = 1);
+
+/**
+ * Ask the OS to back an existing, huge page aligned memory range with transparent huge pages.
+ * Must be called before the memory is first touched to take effect immediately.
+ * @return The page backing that was obtained.
+ */
+PageBacking advise_huge_pages(void* ptr, size_t bytes);
+
+/**
+ * Fixed size array for large tables allocated with allocate_large_pages.
+ * Elements start out zeroed, so T must be valid when all bytes are zero and trivially destructible.
+ */
+template<typename T>
+class LargePageArray {
+    static_assert(std::is_trivially_destructible_v<T>);
+
+public:
+    LargePageArray() = default;
+
+    /**
+     * @param count number of elements
+     * @throw std::bad_alloc if the allocation fails.
+     */
+    explicit LargePageArray(size_t count)
+      : m_data(static_cast<T*>(allocate_large_pages(count * sizeof(T), m_backing))),
+        m_size(count) {}
+
+    ~LargePageArray() { free_large_pages(m_data, m_size * sizeof(T)); }
+
+    /**
+     * Create an array backed by a memory mapped file range, see map_file_pages.
+     * @param path path to the file
+     * @param offset offset of the first element in the file, must be a multiple of 4096
+     * @param count number of elements
+     * @throw std::runtime_error if the file cannot be mapped.
+     */
+    static LargePageArray map_file(const std::string& path, size_t offset, size_t count) {
+        LargePageArray array;
+        array.m_data = static_cast<T*>(map_file_pages(path, offset, count * sizeof(T)));
+        array.m_size = count;
+        array.m_backing = PageBacking::MappedFile;
+        return array;
+    }
+
+    LargePageArray(const LargePageArray&) = delete;
+    LargePageArray& operator=(const LargePageArray&) = delete;
+
+    LargePageArray(LargePageArray&& other) noexcept
+      : m_backing(other.m_backing),
+        m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+    LargePageArray& operator=(LargePageArray&& other) noexcept {
+        if (this != &other) {
+            free_large_pages(m_data, m_size * sizeof(T));
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_backing = other.m_backing;
+        }
+        return *this;
+    }
+
+    /**
+     * Reset all elements to zero, releasing the committed memory where possible.
+     * @param thread_count number of threads to split the work between
+     */
+    void clear(size_t thread_count = 1) {
+        if (m_backing == PageBacking::MappedFile)
+            *this = LargePageArray(m_size); // released pages would read back from the file, swap in fresh memory instead
+        else
+            clear_large_pages(m_data, m_size * sizeof(T), thread_count);
+    }
+
+    T& operator[](size_t index) { return m_data[index]; }
+    const T& operator[](size_t index) const { return m_data[index]; }
+
+    T* begin() { return m_data; }
+    T* end() { return m_data + m_size; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+    size_t size() const { return m_size; }
+    PageBacking backing() const { return m_backing; }
+
+private:
+    PageBacking m_backing = PageBacking::Normal; // declared first, set by the m_data initializer
+    T* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+/**
+ * Key salt for hash tables with generation based clearing. Keys are stored XORed with the salt of the
+ * current generation, so entries from earlier generations never match a probe. Generation 0 has no salt.
+ */
+constexpr uint64_t generation_salt(uint64_t generation) {
+    return generation * 0x9E3779B97F4A7C15ULL;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @return Number of online NUMA nodes. 1 if unknown or not supported on this platform.
+ */
+size_t numa_node_count();
+
+/**
+ * Interleave the pages of a memory range round robin over all online NUMA nodes,
+ * so that a table shared by all search threads is not placed entirely on one node.
+ * Only affects pages that have not been touched yet, so call this right after allocation.
+ * @param ptr start of the range, page aligned
+ * @param bytes size of the range
+ * @return True if the interleave policy was applied. False on single node systems or if not supported.
+ */
+bool interleave_numa_nodes(void* ptr, size_t bytes);
+
+/**
+ * Pin the calling thread to one CPU. Consecutive thread indices are spread round robin over the NUMA nodes,
+ * and within a node over the CPUs the process is allowed to run on.
+ * @param thread_index index of the search thread
+ * @return True if the thread was pinned. False if not supported on this platform.
+ */
+bool pin_thread(size_t thread_index);
@@ -55,6 +55,11 @@ public:
      */
     uint64_t get_pawn_key() const;
 
+    /**
+     * @return A hash key for the material configuration only, i.e. the count of each piece (Zobrist hash).
+     */
+    uint64_t get_material_key() const;
+
     /**
      * @return Which sides turn to move it is currently.
      */
@@ -132,6 +137,14 @@ public:
      */
     bool gives_check(Move move) const;
 
+    /**
+     * Compute the hash key of the position after the given move without making it.
+     * @param move the move to query
+     * @return The key that get_key() would return after make_move(move).
+     * @note The move must be pseudo-legal in the current position.
+     */
+    uint64_t key_after(Move move) const;
+
     /**
      * @param side the side of the attackers
      * @param square the square to query
@@ -220,11 +233,12 @@ public:
 
 private:
     /**
-     * Reversable state transition. 48 bytes, no padding.
+     * Reversable state transition. 64 bytes, no padding.
      */
     struct StoredState {
         uint64_t key;
         uint64_t pawn_key;
+        uint64_t material_key;
         Move move;
         Piece captured_piece;
         uint8_t castling_rights;
@@ -234,7 +248,7 @@ private:
         std::array<Bitboard, 2> king_blockers;
         std::array<Bitboard, 2> pinners;
         StoredState(Move move, Piece captured_piece, uint8_t castling_rights,
-            Square en_passant_square, uint8_t halfmoves, uint64_t key, uint64_t pawn_key,
+            Square en_passant_square, uint8_t halfmoves, uint64_t key, uint64_t pawn_key, uint64_t material_key,
             std::array<Bitboard, 2> king_blockers, std::array<Bitboard, 2> pinners,
             std::array<bool, 2> pins_computed);
     };
@@ -268,6 +282,7 @@ private:
 
     uint64_t m_key;
     uint64_t m_pawn_key;
+    uint64_t m_material_key;
 };
 
 
@@ -316,6 +331,10 @@ inline uint64_t Position::get_pawn_key() const {
     return m_pawn_key;
 }
 
+inline uint64_t Position::get_material_key() const {
+    return m_material_key;
+}
+
 inline Color Position::get_side_to_move() const {
     return m_side_to_move;
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "core/memory.hpp"
+
+struct EvalCacheEntry { // 8 bytes
+    uint32_t key_check; // upper half of the key, salted with the table generation
+    int32_t eval;
+};
+
+/**
+ * Direct-mapped cache of full static evaluations keyed by the position key. Always replace scheme.
+ * Only the upper half of the key is stored, the lower bits are implied by the index.
+ * Keys are stored XORed with a per generation salt, which makes clearing the table O(1).
+ */
+class EvalCache {
+public:
+    /**
+     * @param megabytes size of the table in megabytes
+     */
+    EvalCache(size_t megabytes = 8);
+
+    /**
+     * Clear all entries in the table in O(1) time, by starting a new generation.
+     */
+    void clear();
+
+    /**
+     * Physically reset all entries in the table, and release the committed memory where possible.
+     * @param thread_count number of threads to split the work between
+     */
+    void wipe(size_t thread_count = 1);
+
+    /**
+     * Try to find the evaluation of a position. Counts a hit or a miss.
+     * @param key the position key
+     * @return EvalCacheEntry pointer if found, nullptr if not found
+     */
+    const EvalCacheEntry* find(uint64_t key);
+
+    /**
+     * Store an evaluation in the table
+     * @param key the position key
+     * @param eval the evaluation
+     */
+    void store(uint64_t key, int32_t eval);
+
+    /**
+     * @return Number of probes that found an entry since the last reset_counters().
+     */
+    uint64_t hits() const { return m_hits; }
+
+    /**
+     * @return Number of probes that did not find an entry since the last reset_counters().
+     */
+    uint64_t misses() const { return m_misses; }
+
+    /**
+     * Reset the hit and miss counters.
+     */
+    void reset_counters();
+
+private:
+    LargePageArray<EvalCacheEntry> m_table;
+    size_t m_mask = 0;
+    uint64_t m_generation = 0;
+    uint64_t m_salt = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
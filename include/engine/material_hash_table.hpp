@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "core/memory.hpp"
+
+// Endgame scale factor of a normal (not drawish) material configuration
+constexpr uint8_t SCALE_FACTOR_NORMAL = 64;
+
+struct MaterialTableEntry { // 16 bytes
+    uint64_t key; // salted with the table generation
+    int16_t phase; // material phase, at most PHASE_MAX
+    int16_t imbalance_mg; // material imbalance terms from white's perspective
+    int16_t imbalance_eg;
+    uint8_t scale_factor[2]; // [color] endgame scale when the color is ahead, out of SCALE_FACTOR_NORMAL
+};
+static_assert(sizeof(MaterialTableEntry) == 16);
+
+/**
+ * Material hash table for caching evaluation terms that depend only on the piece counts. Always replace scheme.
+ * Keys are stored XORed with a per generation salt, which makes clearing the table O(1).
+ */
+class MaterialHashTable {
+public:
+    /**
+     * @param megabytes size of the table in megabytes
+     */
+    MaterialHashTable(size_t megabytes = 1);
+
+    /**
+     * Clear all entries in the table in O(1) time, by starting a new generation.
+     */
+    void clear();
+
+    /**
+     * Physically reset all entries in the table, and release the committed memory where possible.
+     * @param thread_count number of threads to split the work between
+     */
+    void wipe(size_t thread_count = 1);
+
+    /**
+     * Try to find an entry with the given key
+     * @param key the key (non-zero)
+     * @return MaterialTableEntry pointer if found, nullptr if not found
+     */
+    const MaterialTableEntry* find(uint64_t key) const;
+
+    /**
+     * Store an entry in the table
+     * @param key the key
+     * @param entry the entry contents, its key field is ignored
+     * @return Pointer to the stored entry.
+     */
+    const MaterialTableEntry* store(uint64_t key, const MaterialTableEntry& entry);
+
+private:
+    LargePageArray<MaterialTableEntry> m_table;
+    size_t m_mask = 0;
+    uint64_t m_generation = 0;
+    uint64_t m_salt = 0;
+};
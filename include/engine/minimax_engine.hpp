@@ -1,16 +1,37 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <vector>
 
 #include "../core/registry.hpp"
 #include "search_position.hpp"
 #include "transposition_table.hpp"
 #include "history_tables.hpp"
+#include "search_parameters.hpp"
 
 void registerMinimaxAI();
 
 enum class NodeType { Root, PV, NonPV };
 
+constexpr int32_t MAX_SEARCH_THREADS = 256;
+constexpr int32_t LMR_TABLE_SIZE = 64; // depths and move counts beyond this use the last entry
+constexpr int32_t MAX_SEARCH_PLY = KILLER_HISTORY_MAX_PLIES;
+constexpr int32_t SEARCH_EVAL_NONE = -1'000'000'000;
+
+/**
+ * Per-ply state of the search, kept in the search stack of MinimaxAI.
+ */
+struct SearchFrame {
+    int32_t static_eval = SEARCH_EVAL_NONE; // SEARCH_EVAL_NONE when in check
+    Move current_move = NO_MOVE;            // move being searched from this ply, NO_MOVE for a null move
+    Move excluded_move = NO_MOVE;           // move skipped at this ply by a verification search
+    bool in_check = false;
+    int32_t reductions = 0;                 // total late move reductions on the line leading to this ply
+};
+
 class MinimaxAI : public AIPlayer {
 public:
     MinimaxAI(const std::vector<ConfigField>& cfg);
@@ -37,11 +58,64 @@ public:
      */
     void set_max_nodes(int64_t nodes);
 
+    /**
+     * Set number of search threads. Helper threads (Lazy SMP) share the transposition table with the main thread.
+     * @param threads the thread count. Clamped to [1, MAX_SEARCH_THREADS].
+     */
+    void set_threads(int threads);
+
+    /**
+     * Enable or disable pinning helper search threads to CPUs, spread over the NUMA nodes.
+     * The main search runs on the calling thread, which is never pinned.
+     * @param enabled true to pin threads
+     */
+    void set_thread_pinning(bool enabled);
+
+    /**
+     * Set the NNUE network used for evaluation. Must not be called while computing. Clears the transposition table.
+     * @param path path to the network file, or an empty string for the hand-crafted evaluation
+     * @throw std::runtime_error if the network cannot be loaded. The current evaluation is kept in that case.
+     */
+    void set_eval_file(const std::string& path);
+
+    /**
+     * Set the tunable search constants. Must not be called while computing.
+     * @param params the parameters
+     */
+    void set_search_parameters(const SearchParameters& params);
+
+    /**
+     * @return The tunable search constants in use.
+     */
+    const SearchParameters& get_search_parameters() const;
+
     /**
      * Clear the transposition table.
      */
     void clear_transposition_table();
 
+    /**
+     * @return The page backing obtained for the transposition table memory.
+     */
+    PageBacking get_tt_page_backing() const;
+
+    /**
+     * Save the transposition table to a file. Must not be called while computing.
+     * @param path path to the file
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void save_transposition_table(const std::string& path) const;
+
+    /**
+     * Load the transposition table from a file written by save_transposition_table. Must not be called while computing.
+     * The table is memory mapped, so loading is instant, and it takes the size stored in the file.
+     * The file must have been saved with the same evaluation (network or hand-crafted weights).
+     * @param path path to the file
+     * @param verify_checksum if true, the checksum of the entries is verified, which reads the whole file
+     * @throw std::runtime_error if the file cannot be loaded. The current table is kept in that case.
+     */
+    void load_transposition_table(const std::string& path, bool verify_checksum = true);
+
     /**
      * Mate finding utility.
      * @return Pair of (mate in N moves, first move). The mate distance is positive for side to move
@@ -60,6 +134,11 @@ public:
         uint64_t tt_raw_hits = 0;
         uint64_t tt_usable_hits = 0;
         uint32_t tt_cutoffs = 0;
+        uint64_t helper_nodes = 0;
+        uint64_t eval_calls = 0;
+        uint64_t tt_eval_hits = 0;
+        uint64_t eval_cache_hits = 0;   // main thread only
+        uint64_t eval_cache_misses = 0; // main thread only
         int32_t eval = 0;
         double time_seconds = 0.0;
         void reset();
@@ -70,34 +149,68 @@ public:
     Stats get_stats() const;
 
 private:
+    // Lazy SMP helper. Shares the transposition table of the main search.
+    explicit MinimaxAI(MinimaxAI& main_search);
+
     void _set_board(const FEN& fen) override;
     void _apply_move(const UCI& move) override;
     void _undo_move() override;
     UCI _compute_move() override;
 
+    // Create/remove helpers to match the thread count and bring them to the current position
+    void _sync_helpers();
+
+    // Iterative deepening loop of a helper thread, runs until the main search stops it
+    void _helper_search(int thread_index);
+
     // Alpha-beta search
     template<NodeType node_type>
-    int32_t _alpha_beta(int32_t alpha, int32_t beta, const int32_t depth, const int32_t ply, const int32_t prior_reductions = 0);
+    int32_t _alpha_beta(int32_t alpha, int32_t beta, const int32_t depth, const int32_t ply);
 
     // Quiescence search
     inline int32_t _quiescence(int32_t alpha, int32_t beta, const int32_t ply);
 
+    // Precompute the late move reduction tables from the search parameters
+    void _build_lmr_table();
+
+    // Late move reduction of a move from the precomputed tables, before history and total reduction limits
+    inline int32_t _lmr_reduction(bool is_pv, int32_t depth, int32_t move_count) const;
+
+    // Static eval of the current position, reused from the TT entry when it has one
+    inline int32_t _static_eval(const std::optional<TTEntry>& tt_entry);
+
+    // Frame of the given ply in the search stack. Frames down to ply -4 exist, so that the search can look back.
+    inline SearchFrame* _frame(int32_t ply);
+
+    // Clear the search stack before a new iteration
+    void _reset_search_stack();
+
     // True if search should stop (time/node limit reached or stop requested)
     inline bool _stop_check();
 
+    // Nodes searched so far by this search and its helpers, for the UCI output during the search
+    int64_t _total_nodes() const;
+
 private:
     // Search parameters
     int32_t m_max_depth = 99;
     double m_time_limit_seconds = 5.0;
     int64_t m_max_nodes = std::numeric_limits<int64_t>::max();
     const size_t m_tt_size_megabytes = 256ULL;
+    int32_t m_threads = 1;
+    bool m_pin_threads = false;
+    std::shared_ptr<const NnueNetwork> m_nnue; // nullptr for the hand-crafted evaluation
+    SearchParameters m_params;
+    int8_t m_lmr_table[2][LMR_TABLE_SIZE][LMR_TABLE_SIZE]; // [is_pv][depth][move_count]
 
     // Search state
     SearchPosition m_spos;
-    TranspositionTable m_tt;
+    std::shared_ptr<TranspositionTable> m_tt;
     KillerHistory m_killer_history;
     MoveHistory m_move_history;
 
+    std::array<SearchFrame, MAX_SEARCH_PLY + 5> m_search_stack;
+
     Move m_root_best_move;
     int32_t m_root_best_score;
     int32_t m_seldepth;
@@ -108,6 +221,15 @@ private:
     int64_t m_nodes_visited = 0;
     bool m_stop_search = false;
 
+    // Lazy SMP
+    MinimaxAI* const m_main_search = nullptr; // nullptr for the main search itself
+    std::vector<std::unique_ptr<MinimaxAI>> m_helpers;
+    std::atomic_bool m_helpers_stop = false;
+    std::atomic<int64_t> m_published_nodes = 0; // m_nodes_visited of a helper, published every 1024 nodes for _total_nodes()
+    bool m_helpers_synced = false;
+    FEN m_root_fen;
+    std::vector<Move> m_game_moves;
+
     // Statistics
     const bool m_enable_uci_output = true;
     Stats m_stats;
@@ -60,8 +60,10 @@ public:
      * @param tt_move the transposition table best move to prioritize (can be NO_MOVE)
      * @param killer_history pointer to the killer history for the current search
      * @param move_history pointer to the move history for the current search
+     * @param excluded_move move that is never picked, used by the singular extension search (can be NO_MOVE)
      */
-    MovePicker(const Position& position, int ply, const Move tt_move, KillerHistory* killer_history, MoveHistory* move_history);
+    MovePicker(const Position& position, int ply, const Move tt_move, KillerHistory* killer_history, MoveHistory* move_history,
+               const Move excluded_move = NO_MOVE);
 
     /**
      * Move picker for quiescence search.
@@ -72,7 +74,7 @@ public:
     MovePicker(const Position& position, const Move tt_move, MoveHistory* move_history);
 
     /**
-     * Stop any future quiet moves from being picked.
+     * Stop any future quiet moves, including killers, from being picked. Quiet moves giving check are still picked.
      */
     void skip_quiets();
 
@@ -93,6 +95,11 @@ public:
     MovePickStage current_stage() const { return m_stage; }
 
 private:
+    /**
+     * @return Next move of the current stage, advancing the stages as needed. Returns NO_MOVE if no moves are left.
+     */
+    Move pick();
+
     /**
      * Score the moves in the given move list according to various heuristics.
      * @tparam gen_type Type of moves in the move list (Captures, Quiets or Evasions)
@@ -110,6 +117,7 @@ private:
 
     MovePickStage m_stage;
     Move m_tt_move;
+    Move m_excluded_move = NO_MOVE;
     KillerHistory* m_killer_history;
     MoveHistory* m_move_history;
 
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "core/position.hpp"
+
+// Network shape: (NNUE_INPUTS -> NNUE_HIDDEN) x 2 perspectives -> 1
+// Inputs are [own/opponent piece][piece type][square], with squares flipped vertically for black's perspective.
+constexpr int NNUE_INPUTS = 768;
+constexpr int NNUE_HIDDEN = 256;
+
+// Quantization
+constexpr int32_t NNUE_QA = 255;         // feature transformer scale, hidden activations are clipped to [0, QA]
+constexpr int32_t NNUE_QB = 64;          // output weight scale
+constexpr int32_t NNUE_EVAL_SCALE = 400; // network output to centipawns
+
+/**
+ * @param perspective color the features are oriented for
+ * @param piece the piece
+ * @param square square of the piece
+ * @return Input feature index of the piece on the square.
+ */
+constexpr int nnue_feature_index(Color perspective, Piece piece, Square square) {
+    const int relative_square = perspective == Color::White ? +square : (+square ^ 56);
+    const int own = to_color(piece) == perspective ? 0 : 1;
+    return own * 384 + +to_type(piece) * 64 + relative_square;
+}
+
+/**
+ * First layer outputs for both perspectives, before activation.
+ */
+struct NnueAccumulator {
+    alignas(64) int16_t values[2][NNUE_HIDDEN]; // [perspective color]
+    bool valid = false;
+};
+
+/**
+ * Pieces added to and removed from the board by a move. The first entries are the moved piece.
+ */
+struct NnueFeatureDelta {
+    Piece added_pieces[2];
+    Square added_squares[2];
+    Piece removed_pieces[2];
+    Square removed_squares[2];
+    int added_count = 0;
+    int removed_count = 0;
+
+    void add(Piece piece, Square square) {
+        added_pieces[added_count] = piece;
+        added_squares[added_count++] = square;
+    }
+    void remove(Piece piece, Square square) {
+        removed_pieces[removed_count] = piece;
+        removed_squares[removed_count++] = square;
+    }
+};
+
+/**
+ * Quantized NNUE evaluation network. Immutable after loading, so one instance is shared by all search threads.
+ * Inference uses AVX2 or SSE2 integer SIMD when the build supports it, otherwise plain scalar code.
+ */
+struct NnueNetwork {
+    alignas(64) int16_t feature_weights[NNUE_INPUTS][NNUE_HIDDEN];
+    alignas(64) int16_t feature_biases[NNUE_HIDDEN];
+    alignas(64) int16_t output_weights[2][NNUE_HIDDEN]; // [side to move / other side][hidden]
+    int32_t output_bias;                                // in QA * QB units
+
+    /**
+     * Load a network from a file written by save().
+     * @param path path to the file
+     * @return The loaded network.
+     * @throw std::runtime_error if the file cannot be read or is not a compatible network.
+     */
+    static std::shared_ptr<const NnueNetwork> load(const std::string& path);
+
+    /**
+     * Save the network to a file.
+     * @param path path to the file
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @return Checksum of the network parameters, the same as stored in the network file.
+     */
+    uint64_t checksum() const;
+
+    /**
+     * Compute the accumulator of a position from scratch.
+     * @param accumulator accumulator to fill
+     * @param position the position
+     */
+    void refresh(NnueAccumulator& accumulator, const Position& position) const;
+
+    /**
+     * Compute the accumulator after a move from the accumulator before it.
+     * @param from accumulator before the move
+     * @param to accumulator to fill
+     * @param delta pieces added and removed by the move
+     */
+    void update(const NnueAccumulator& from, NnueAccumulator& to, const NnueFeatureDelta& delta) const;
+
+    /**
+     * @param accumulator accumulator of the position
+     * @param side_to_move side to move in the position
+     * @return Evaluation in centipawns from the perspective of the side to move.
+     */
+    int32_t evaluate(const NnueAccumulator& accumulator, Color side_to_move) const;
+};
@@ -1,15 +1,35 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+#include "core/bitboard.hpp"
+#include "core/memory.hpp"
 
-struct PawnTableEntry { // 16 bytes
-    uint64_t key;
-    int32_t eval;
+struct alignas(64) PawnTableEntry { // 64 bytes, one cache line
+    uint64_t key; // salted with the table generation
+    int16_t eval; // pawn structure evaluation from white's perspective
+
+    // Per side [color] pawn structure data, reused by the rest of the evaluation
+    uint8_t semi_open_files[2];   // files without own pawns, bit per file
+    Square shield_king_square[2]; // king square shield_count was computed for, Square::None if not yet
+    int8_t shield_count[2];       // own pawns shielding the king on shield_king_square
+    Bitboard passed_pawns[2];
+    Bitboard pawn_attacks[2];
+    Bitboard attack_spans[2];     // squares the pawns attack now or after advancing
 };
+static_assert(sizeof(PawnTableEntry) == 64);
+
+/**
+ * Compute the per side pawn bitboards of an entry. The evaluation and the Texel tuner read the pawn sets from here.
+ * @param w_pawns white pawns
+ * @param b_pawns black pawns
+ * @return Entry with the bitboards set, zero eval and an empty king shield cache. Key is not set.
+ */
+PawnTableEntry compute_pawn_sets(Bitboard w_pawns, Bitboard b_pawns);
 
 /**
  * Pawn hash table for caching pawn structure evaluations. Always replace scheme.
+ * Keys are stored XORed with a per generation salt, which makes clearing the table O(1).
  */
 class PawnHashTable {
 public:
@@ -19,25 +39,35 @@ public:
     PawnHashTable(size_t megabytes = 4);
 
     /**
-     * Clear all entries in the table.
+     * Clear all entries in the table in O(1) time, by starting a new generation.
      */
     void clear();
 
+    /**
+     * Physically reset all entries in the table, and release the committed memory where possible.
+     * @param thread_count number of threads to split the work between
+     */
+    void wipe(size_t thread_count = 1);
+
     /**
      * Try to find an entry with the given key
      * @param key the key (non-zero)
      * @return PawnTableEntry pointer if found, nullptr if not found
+     * @note The king shield fields of the entry may be updated in place.
      */
-    const PawnTableEntry* find(uint64_t key) const;
+    PawnTableEntry* find(uint64_t key);
 
     /**
      * Store an entry in the table
      * @param key the key
-     * @param eval the pawn evaluation
+     * @param entry the entry contents, its key field is ignored
+     * @return Pointer to the stored entry.
      */
-    void store(uint64_t key, int32_t eval);
+    PawnTableEntry* store(uint64_t key, const PawnTableEntry& entry);
 
-private:        
-    std::vector<PawnTableEntry> m_table;
+private:
+    LargePageArray<PawnTableEntry> m_table;
     size_t m_mask = 0;
+    uint64_t m_generation = 0;
+    uint64_t m_salt = 0;
 };
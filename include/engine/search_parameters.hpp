@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Tunable constants of the search. The defaults are the hand-picked values the search was developed with.
+ * Every field is listed in SearchParameters::table(), which gives it a name and a tuning range.
+ */
+struct SearchParameters {
+    // Null move pruning: tried when static eval >= beta + margin, with reduction R = reduction + (depth >= deep_depth)
+    int32_t null_move_margin = 13;
+    int32_t null_move_reduction = 3;
+    int32_t null_move_deep_depth = 8;
+
+    // Futility pruning: margin = base + depth * depth_margin + history / history_divisor,
+    // smaller by improving_margin when the static eval is not improving
+    int32_t futility_base_margin = 48;
+    int32_t futility_depth_margin = 91;
+    int32_t futility_history_divisor = 32;
+    int32_t futility_improving_margin = 40;
+
+    // Late move reductions: base / 100 + log(depth) * log(move_count) / (divisor / 100), separately for PV and non-PV nodes.
+    // Quiet moves are reduced history / lmr_history_divisor less, and moves in non-improving nodes lmr_not_improving more.
+    // At most lmr_max_reduction plies in total along a line.
+    int32_t lmr_base = 100;
+    int32_t lmr_divisor = 320;
+    int32_t lmr_base_pv = 100;
+    int32_t lmr_divisor_pv = 320;
+    int32_t lmr_history_divisor = 500;
+    int32_t lmr_not_improving = 1;
+    int32_t lmr_max_reduction = 3;
+
+    // Reverse futility pruning: a non-PV node fails high if static eval - depth_margin * (depth - improving) >= beta
+    int32_t rfp_enabled = 1;
+    int32_t rfp_max_depth = 6;
+    int32_t rfp_depth_margin = 80;
+
+    // Razoring: a quiescence search decides the node if static eval + base + depth^2 * depth_margin <= alpha
+    int32_t razoring_enabled = 1;
+    int32_t razor_max_depth = 3;
+    int32_t razor_base_margin = 500;
+    int32_t razor_depth_margin = 300;
+
+    // Late move pruning: remaining quiets are skipped after (base + depth^2) / (2 - improving) moves
+    int32_t lmp_enabled = 1;
+    int32_t lmp_max_depth = 6;
+    int32_t lmp_base = 3;
+
+    // SEE pruning: quiet moves losing more than depth * margin in exchanges are skipped
+    int32_t see_quiet_pruning_enabled = 1;
+    int32_t see_quiet_max_depth = 6;
+    int32_t see_quiet_margin = 60;
+
+    // Singular extensions: at depth >= min_depth, the TT move with a lower bound from at least depth - tt_depth_margin is extended
+    // if all other moves fail low against tt_score - beta_margin * depth in a half-depth search. If that window is at or above
+    // beta and some other move reaches it, the node is cut instead (multi-cut).
+    int32_t singular_enabled = 1;
+    int32_t singular_min_depth = 8;
+    int32_t singular_tt_depth_margin = 3;
+    int32_t singular_beta_margin = 3;
+
+    // Quiescence delta pruning margin on top of the captured piece value
+    int32_t delta_margin = 150;
+
+    /**
+     * Name and tuning range of a parameter.
+     */
+    struct Info {
+        const char* name;
+        int32_t SearchParameters::* member;
+        int32_t min;
+        int32_t max;
+        double step; // SPSA perturbation size at the end of tuning, 0 for switches that are not tuned
+    };
+
+    /**
+     * @return All parameters in declaration order.
+     */
+    static const std::vector<Info>& table();
+
+    /**
+     * @param name parameter name
+     * @return Value of the parameter.
+     * @throw std::invalid_argument if the name is unknown.
+     */
+    int32_t get(const std::string& name) const;
+
+    /**
+     * Set a parameter by name.
+     * @param name parameter name
+     * @param value new value
+     * @throw std::invalid_argument if the name is unknown or the value is out of the parameter range.
+     */
+    void set(const std::string& name, int32_t value);
+
+    /**
+     * @return The parameters as "name value" lines.
+     */
+    std::string to_string() const;
+
+    /**
+     * Parse "name value" lines written by to_string(). Missing parameters keep their defaults,
+     * empty lines and lines starting with '#' are skipped.
+     * @param text the lines
+     * @return The parameters.
+     * @throw std::invalid_argument if a line cannot be parsed, or a name or value is invalid.
+     */
+    static SearchParameters parse(const std::string& text);
+
+    /**
+     * Load parameters from a file in the format of parse().
+     * @param path path to the file
+     * @return The parameters.
+     * @throw std::runtime_error if the file cannot be read.
+     * @throw std::invalid_argument if the contents are invalid.
+     */
+    static SearchParameters load(const std::string& path);
+
+    bool operator==(const SearchParameters&) const = default;
+};
@@ -3,12 +3,9 @@
 #include "../core/position.hpp"
 #include "engine/value_tables.hpp"
 #include "engine/pawn_hash_table.hpp"
-
-struct Eval {
-    int32_t mg_eval;  // middle game eval
-    int32_t eg_eval;  // end game eval
-    int32_t phase;    // material on board
-};
+#include "engine/material_hash_table.hpp"
+#include "engine/eval_cache.hpp"
+#include "engine/nnue.hpp"
 
 /**
  * Incremental evaluation wrapper for Position.
@@ -17,8 +14,9 @@ class SearchPosition {
 public:
     /**
      * Create without setting board state. Call set_board() after.
+     * @param eval_cache_megabytes size of the evaluation cache in megabytes
      */
-    SearchPosition();
+    SearchPosition(size_t eval_cache_megabytes = 8);
 
     /**
      * Set board configuration from a FEN description.
@@ -29,9 +27,20 @@ public:
 
     /**
      * @return Position evaluation from the perspective of side to move.
+     * @note Cached by position key, see get_eval_cache().
      */
     int32_t get_eval() const;
 
+    /**
+     * @return The evaluation cache, for its hit and miss counters.
+     */
+    const EvalCache& get_eval_cache() const;
+
+    /**
+     * Reset the hit and miss counters of the evaluation cache.
+     */
+    void reset_eval_cache_counters();
+
     /**
      * @return How many times the current position has occurred in the move history.
      * @note e.g. 1 if the current position is the first occurence in the history.
@@ -45,9 +54,30 @@ public:
 
     /**
      * @return Current material phase value. Weighted sum of all pieces on the board.
+     * @note Cached by material key.
      */
     int32_t material_phase() const;
 
+    /**
+     * Enable or disable the static features (outposts, king safety and mobility) in get_eval(). Enabled by default.
+     * Clears the evaluation cache.
+     * @param enabled true to include the static features
+     */
+    void set_static_features(bool enabled);
+
+    /**
+     * Use an NNUE network for get_eval() instead of the hand-crafted evaluation.
+     * The accumulators are updated incrementally with each move. Clears the evaluation cache.
+     * @param network the network, or nullptr for the hand-crafted evaluation
+     */
+    void set_nnue(std::shared_ptr<const NnueNetwork> network);
+
+    /**
+     * @return Fingerprint of the evaluation used by get_eval(): the NNUE network checksum, or a hash of the hand-crafted
+     * weights and the static features setting. Static evals computed under a different fingerprint are not valid.
+     */
+    uint64_t eval_fingerprint() const;
+
     /**
      * Make a move on the board.
      * @param move the move.
@@ -78,16 +108,6 @@ public:
     const Position& get_position() const;
 
 private:
-    /**
-     * Piece-Square Table value.
-     * @param type piece type
-     * @param color player color
-     * @param square square index 0-63 (8 * rank + file)
-     * @param stage game stage (middlegame/endgame)
-     * @return Evaluation value for the piece on the square.
-     */
-    int32_t _pst_value(PieceType type, Color color, Square square, GamePhase stage) const;
-
     /**
      * @param type piece type
      * @return Evaluation material value for the piece.
@@ -96,28 +116,69 @@ private:
 
     /**
      * Calculate the full base evaluation from the current position.
+     * Does not include the material imbalance terms.
      * @return The evaluation from white's perspective.
      */
-    Eval _compute_base_eval();
+    Score _compute_base_eval();
+
+    /**
+     * @return Material table entry of the current position, computed and stored on a miss.
+     */
+    const MaterialTableEntry& _material_entry() const;
+
+    /**
+     * @return Pawn table entry of the current position, computed and stored on a miss.
+     */
+    PawnTableEntry& _pawn_entry() const;
+
+    /**
+     * Evaluate terms that depend only on the piece counts.
+     * @return Material table entry with the phase, imbalance from white's perspective
+     * and endgame scale factors. Key is not set.
+     */
+    MaterialTableEntry _eval_material() const;
 
     /**
      * Evaluate pawn structure.
-     * @return Pawn structure evaluation from white's perspective.
+     * @return Pawn table entry with the evaluation from white's perspective and the pawn bitboards. Key is not set.
      */
-    int32_t _eval_pawns() const;
+    PawnTableEntry _eval_pawns() const;
 
     /**
      * Evaluate static features, that are not dynamically updated. Does not include pawn structure.
-     * @param eval Eval structure to update.
+     * @param eval Score to update, from white's perspective.
+     * @param pawns Pawn table entry of the current position, its king shield cache is updated.
      */
-    void _eval_static_features(Eval& eval) const;
+    void _eval_static_features(Score& eval, PawnTableEntry& pawns) const;
+
+    /**
+     * Evaluate mobility and king zone attacks of all pieces of one type and side.
+     * @tparam type Knight, Bishop, Rook or Queen
+     * @param side color of the pieces
+     * @param occupied all pieces on the board
+     * @param mobility_area squares counted towards mobility
+     * @param king_zone opponent king zone squares counted as attacked
+     * @param attack_value king zone attack value of the side, updated
+     * @param attack_count number of pieces of the side attacking the king zone, updated
+     * @return Mobility score of the pieces.
+     */
+    template<PieceType type>
+    Score _eval_piece_attacks(Color side, Bitboard occupied, Bitboard mobility_area, Bitboard king_zone,
+                              Score& attack_value, int32_t& attack_count) const;
 
 private:
     Position m_position;
 
     // Evaluation from white's perspective
-    std::vector<Eval> m_base_evals;
+    std::vector<Score> m_base_evals;
     mutable PawnHashTable m_pawn_hash_table;
+    mutable MaterialHashTable m_material_hash_table;
+    bool m_static_features = true;
+    mutable EvalCache m_eval_cache; // not cleared on set_board(), the evaluation depends only on the position
+
+    // NNUE evaluation, accumulators are indexed like m_base_evals
+    std::shared_ptr<const NnueNetwork> m_nnue;
+    std::vector<NnueAccumulator> m_accumulators;
 
     // Ply history
     std::vector<uint64_t> m_zobrist_history;
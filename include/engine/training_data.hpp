@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "core/position.hpp"
+#include "engine/nnue.hpp"
+
+// Game results in training data, from white's perspective
+constexpr uint8_t RESULT_BLACK_WIN = 0;
+constexpr uint8_t RESULT_DRAW = 1;
+constexpr uint8_t RESULT_WHITE_WIN = 2;
+
+/**
+ * Labelled position for NNUE training, packed into 32 bytes. Training files are plain arrays of these (native byte order).
+ * Castling, en passant and the move clocks are not stored since the network does not see them.
+ */
+struct PackedPosition {
+    uint64_t occupancy;  // squares with a piece
+    uint8_t pieces[16];  // 4-bit piece values in occupancy order from the lowest square, low nibble first
+    int16_t score;       // search score in centipawns, from white's perspective
+    uint8_t result;      // RESULT_* constant
+    uint8_t side_to_move;
+    uint8_t padding[4];
+};
+static_assert(sizeof(PackedPosition) == 32);
+
+/**
+ * @param position the position, must have at most 32 pieces
+ * @param score search score in centipawns, from white's perspective
+ * @param result RESULT_* constant
+ * @return The packed position.
+ */
+PackedPosition pack_position(const Position& position, int16_t score, uint8_t result);
+
+/**
+ * Parse a text training line "<fen> | <score> | <result>", where score is in centipawns from white's perspective
+ * and result is 1.0, 0.5 or 0.0 from white's perspective.
+ * @param line the line
+ * @return The packed position.
+ * @throw std::invalid_argument if the line is malformed or the FEN is invalid.
+ */
+PackedPosition parse_training_line(const std::string& line);
+
+/**
+ * Write the NNUE input feature indices of a packed position, using the same indexing as the engine.
+ * @param position the packed position
+ * @param perspective color the features are oriented for
+ * @param features output array with room for 32 indices
+ * @return Number of features written.
+ */
+inline int packed_features(const PackedPosition& position, Color perspective, int* features) {
+    int count = 0;
+    Bitboard occupancy = position.occupancy;
+    while (occupancy) {
+        const Piece piece = static_cast<Piece>((position.pieces[count >> 1] >> ((count & 1) * 4)) & 0xF);
+        features[count++] = nnue_feature_index(perspective, piece, lsb(occupancy));
+        pop_lsb(occupancy);
+    }
+    return count;
+}
@@ -1,21 +1,34 @@
 #pragma once
 
-#include <vector>
+#include <atomic>
+#include <limits>
+#include <optional>
+#include <string>
 #include "core/types.hpp"
+#include "core/memory.hpp"
 
 enum class Bound : uint8_t { Exact=0, Lower=1, Upper=2, None=3 };
 
-struct TTEntry { // 24 bytes aligned
+// Stored static eval of an entry without one
+constexpr int16_t TT_EVAL_NONE = std::numeric_limits<int16_t>::min();
+
+struct TTEntry { // snapshot of a table slot
     uint64_t key;
-    int32_t score;
+    int16_t score;
     Move best_move;
     int16_t depth;
     Bound bound;
     uint8_t age;
+    int16_t eval;
 };
 
 /**
- * Open-addressing transposition table with linear probing.
+ * Lock-free transposition table of 64-byte clusters, each holding four 16-byte slots.
+ * A probe touches exactly one cache line. Safe to probe and store from any number of threads at the same time.
+ *
+ * Each slot holds the entry packed into one 64-bit data word, and the key XORed with that data word.
+ * A slot torn by concurrent stores fails the key check on probe, so it is simply treated as a miss.
+ * Keys are also XORed with a per generation salt, which makes clearing the table O(1).
  */
 class TranspositionTable {
 public:
@@ -25,36 +38,106 @@ public:
     TranspositionTable(size_t megabytes = 256);
 
     /**
-     * Clear all entries in the table.
+     * Clear all entries in the table in O(1) time, by starting a new generation.
+     * Entries from earlier generations are never found, and are replaced first.
+     * @warning Not safe to call while other threads access the table.
      */
     void clear();
 
+    /**
+     * Physically reset all entries in the table, and release the committed memory where possible.
+     * @param thread_count number of threads to split the work between
+     * @warning Not safe to call while other threads access the table.
+     */
+    void wipe(size_t thread_count = 1);
+
     /**
      * Try to find an entry with the given key
      * @param key the key (non-zero)
-     * @return TTEntry pointer if found, nullptr if not found
+     * @return Copy of the entry if found, std::nullopt if not found
+     */
+    std::optional<TTEntry> find(uint64_t key) const;
+
+    /**
+     * Hint the CPU to start loading the cluster of the given key into cache.
+     * Issue this early (e.g. before making a move), so the memory latency overlaps with other work before find().
+     * @param key the key
      */
-    const TTEntry* find(uint64_t key) const;
+    void prefetch(uint64_t key) const;
 
     /**
-     * Store an entry in the table
+     * Store an entry in the table. An entry of the same key from the current search is kept if it is more than a few plies
+     * deeper and the new bound is not exact. When overwriting the same key, a missing move or eval keeps the stored one.
      * @param key the key
-     * @param score the score
-     * @param depth the search depth
+     * @param score the score (16-bit, mate scores must be encoded by the caller)
+     * @param depth the search depth (stored clamped to 8 bits)
      * @param bound the bound type
-     * @param best_move the best move (32 bit encoded)
+     * @param best_move the best move (16 bit encoded)
+     * @param eval the static evaluation of the position (stored clamped to 16 bits), or TT_EVAL_NONE
      */
-    void store(uint64_t key, int32_t score, int16_t depth,
-                Bound bound, Move best_move);
-    
+    void store(uint64_t key, int16_t score, int16_t depth,
+                Bound bound, Move best_move, int32_t eval = TT_EVAL_NONE);
+
     /**
      * Increment the age counter for the next search iteration.
+     * @warning Not safe to call while other threads access the table.
      */
     void new_search_iteration();
 
+    /**
+     * @return The page backing obtained for the table memory.
+     */
+    PageBacking page_backing() const;
+
+    /**
+     * Save the table contents to a versioned binary file.
+     * @param path path to the file, overwritten if it exists
+     * @param eval_fingerprint identifies the evaluation the stored static evals come from
+     * @throw std::runtime_error if the file cannot be written.
+     * @warning Not safe to call while other threads store to the table.
+     */
+    void save(const std::string& path, uint64_t eval_fingerprint = 0) const;
+
+    /**
+     * Replace the table with the contents of a file written by save(). The table takes the size stored in the file.
+     * The file is memory mapped, so entries are read from disk only when first probed.
+     * @param path path to the file
+     * @param verify_checksum if true, the checksum of the entries is verified, which reads the whole file
+     * @param eval_fingerprint fingerprint of the current evaluation, must match the one the file was saved with
+     * @throw std::runtime_error if the file cannot be read, is from an incompatible version or build
+     * (different Zobrist keys), was saved under a different evaluation, or fails the checksum.
+     * The table is left unchanged in that case.
+     * @warning Not safe to call while other threads access the table.
+     */
+    void load(const std::string& path, bool verify_checksum = true, uint64_t eval_fingerprint = 0);
+
 private:
-    std::vector<TTEntry> m_table;
+    struct Slot { // 16 bytes
+        std::atomic<uint64_t> key_xor_data;
+        std::atomic<uint64_t> data;
+    };
+
+    static constexpr size_t CLUSTER_SIZE = 4;
+    struct alignas(64) Cluster { // 64 bytes, one cache line
+        Slot slots[CLUSTER_SIZE];
+    };
+    static_assert(sizeof(Cluster) == 64);
+
+    LargePageArray<Cluster> m_table;
     size_t m_mask = 0;
-    const size_t m_probe_window = 2;
     uint8_t m_age = 0;
-};
\ No newline at end of file
+    uint64_t m_generation = 0;
+    uint64_t m_salt = 0;
+};
+
+inline PageBacking TranspositionTable::page_backing() const {
+    return m_table.backing();
+}
+
+inline void TranspositionTable::prefetch(uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&m_table[key & m_mask]);
+#else
+    (void)key;
+#endif
+}
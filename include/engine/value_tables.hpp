@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <array>
+#include "core/types.hpp"
 
 // ----------
 // Game Phase
@@ -39,6 +40,31 @@ constexpr int32_t PHASE_LATE_ENDGAME = 7;
 // Phase width
 constexpr int32_t PHASE_WIDTH = PHASE_MAX - PHASE_MIN;
 
+// -------------
+// Packed Scores
+// -------------
+
+// Middlegame and endgame values packed into one integer, so that both are updated with a single add/sub.
+// Middlegame value in the lower 32 bits, endgame value in the upper 32 bits (borrowing from the middlegame lane).
+enum class Score : int64_t { Zero = 0 };
+
+constexpr Score make_score(int32_t mg, int32_t eg) {
+    return static_cast<Score>((static_cast<int64_t>(eg) << 32) + mg);
+}
+constexpr int32_t mg_value(Score score) {
+    return static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(score)));
+}
+constexpr int32_t eg_value(Score score) {
+    return static_cast<int32_t>(static_cast<uint32_t>((static_cast<uint64_t>(score) + 0x80000000ULL) >> 32));
+}
+
+constexpr Score operator+(Score a, Score b) { return static_cast<Score>(static_cast<int64_t>(a) + static_cast<int64_t>(b)); }
+constexpr Score operator-(Score a, Score b) { return static_cast<Score>(static_cast<int64_t>(a) - static_cast<int64_t>(b)); }
+constexpr Score operator-(Score a) { return static_cast<Score>(-static_cast<int64_t>(a)); }
+constexpr Score operator*(int32_t k, Score a) { return static_cast<Score>(k * static_cast<int64_t>(a)); }
+constexpr Score& operator+=(Score& a, Score b) { return a = a + b; }
+constexpr Score& operator-=(Score& a, Score b) { return a = a - b; }
+
 // ------------
 // Piece Values
 // ------------
@@ -58,6 +84,11 @@ constexpr int32_t BISHOP_PAIR_VALUE[2] = {30, 60}; // [gamephase]
 constexpr int32_t KNIGHT_PAIR_VALUE[2] = {40, 10}; // [gamephase]
 constexpr int32_t KNIGHT_OUTPOST_VALUE[2] = {30, 20}; // [gamephase]
 
+constexpr int32_t ROOK_FILE_VALUES[2][2] = { // [open][gamephase]
+    {15, 5},  // Semi-open file
+    {35, 10}, // Open file
+};
+
 
 // --------
 // Mobility
@@ -84,7 +115,7 @@ constexpr int32_t ATTACK_VALUES[4][2] = { // [piece][gamephase]
     {80, 40}, // Queen
 };
 
-// Multiplier based on number of attacks
+// Percentage multiplier based on the number of pieces attacking the king zone
 constexpr int32_t ATTACK_COUNT_MULTIPLIER[7] = {
     0, 50, 75, 88, 94, 97, 100
 };
@@ -99,6 +130,7 @@ constexpr int32_t TRIPLED_PAWN_VALUE = -50;
 constexpr int32_t BACKWARD_PAWN_VALUE = -12;
 constexpr int32_t ISOLATED_PAWN_VALUES[] = {-14, -14, -16, -20, -20, -16, -14, -14}; // by file
 constexpr int32_t PASSED_PAWN_VALUES[] = {0, 0, 14, 24, 40, 60, 80, 0}; // by rank
+constexpr int32_t BLOCKED_PASSED_PAWN_VALUE[2] = {-5, -15}; // [gamephase], stop square occupied by any piece
 
 // -------------------
 // Piece-Square Tables
@@ -146,14 +178,14 @@ constexpr int32_t PST_KNIGHT[2][64] = {{ // [gamephase][square]
 
 
 constexpr int32_t PST_BISHOP[2][64] = {{ // [gamephase][square]
-    -20, -10, -40, -10, -10,- 40, -10, -20,
+    -20, -10, -40, -10, -10, -40, -10, -20,
     -10,  15,   0,   0,   0,   0,  15, -10,
     -10,  10,  10,  10,  10,  10,  10, -10,
     -10,   0,  10,  10,  10,  10,   0, -10,
     -10,   5,   5,  10,  10,   5,   5, -10,
     -10,   0,   5,  10,  10,   5,   0, -10,
     -10,   0,   0,   0,   0,   0,   0, -10,
-    -20, -10, -10, -10, -10,- 10, -10, -20
+    -20, -10, -10, -10, -10, -10, -10, -20
     },{
     -21, -10, -10, -12, -12, -10, -10, -21,
     -10,   0,   0,   0,   0,   0,   0, -10,
@@ -225,3 +257,26 @@ constexpr int32_t PST_KING[2][64] = {{ // [gamephase][square]
     -30, -20, -10,   0,   0, -10, -20, -30,
     -50, -40, -30, -20, -20, -30, -40, -50
 }};
+
+// -----------------------------
+// Combined Piece-Square Table
+// -----------------------------
+
+// Material and piece-square values in one table, from white's perspective (negative for black pieces)
+constexpr std::array<std::array<Score, 64>, 16> make_psqt() {
+    std::array<std::array<Score, 64>, 16> table{};
+    const int32_t (*pst[6])[64] = {PST_KNIGHT, PST_BISHOP, PST_ROOK, PST_QUEEN, PST_KING, PST_PAWN};
+    for (Color color : {Color::White, Color::Black}) {
+        const int32_t sign = (color == Color::White) ? 1 : -1;
+        for (int type = 0; type < 6; ++type) {
+            for (int square = 0; square < 64; ++square) {
+                const int idx = +square_for_side(Square(square), color);
+                table[+create_piece(color, PieceType(type))][square] = sign * make_score(
+                    PIECE_VALUES[type] + pst[type][+GamePhase::Middlegame][idx],
+                    PIECE_VALUES[type] + pst[type][+GamePhase::Endgame][idx]);
+            }
+        }
+    }
+    return table;
+}
+constexpr std::array<std::array<Score, 64>, 16> PSQT = make_psqt(); // [piece][square]
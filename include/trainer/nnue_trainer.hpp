@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "engine/nnue.hpp"
+#include "engine/training_data.hpp"
+
+struct NnueTrainerConfig {
+    int epochs = 10;
+    size_t batch_size = 16384;
+    float learning_rate = 0.001f;
+    float learning_rate_decay = 0.9f; // multiplier applied after each epoch
+    float lambda = 0.75f;             // weight of the search score in the target, the rest is the game result
+    int threads = 1;
+    uint64_t seed = 1;
+    size_t shuffle_batches = 64;      // batches read from disk and shuffled together
+};
+
+/**
+ * CPU trainer for the engine's NNUE network.
+ * Trains a float copy of the network with Adam on the squared error between sigmoid(eval)
+ * and a blend of sigmoid(score) and the game result. Each minibatch is split between threads,
+ * which accumulate their own gradients that are then summed and applied in parallel.
+ */
+class NnueTrainer {
+public:
+    /**
+     * Create a trainer with a randomly initialized network.
+     * @param config training parameters
+     */
+    explicit NnueTrainer(const NnueTrainerConfig& config);
+
+    /**
+     * Run one optimization step on a minibatch.
+     * @param positions the positions
+     * @param count number of positions
+     * @return Mean loss of the minibatch before the step.
+     */
+    double train_batch(const PackedPosition* positions, size_t count);
+
+    /**
+     * Train on a file of packed positions for the configured number of epochs, streaming it from disk.
+     * The quantized network is written after each epoch. Progress is printed to stdout.
+     * @param data_path path to a file of PackedPosition records
+     * @param output_path path of the network file to write
+     * @throw std::runtime_error if the data file cannot be read or the network cannot be written.
+     */
+    void train(const std::string& data_path, const std::string& output_path);
+
+    /**
+     * @param position the position
+     * @return Float network evaluation in centipawns from the perspective of the side to move.
+     */
+    float evaluate(const PackedPosition& position) const;
+
+    /**
+     * @return The network quantized to the format the engine loads.
+     */
+    std::unique_ptr<NnueNetwork> quantize() const;
+
+private:
+    // Parameter layout in the flat parameter, gradient and moment vectors
+    static constexpr size_t FEATURE_WEIGHTS = 0;
+    static constexpr size_t FEATURE_BIASES = FEATURE_WEIGHTS + size_t(NNUE_INPUTS) * NNUE_HIDDEN;
+    static constexpr size_t OUTPUT_WEIGHTS = FEATURE_BIASES + NNUE_HIDDEN;
+    static constexpr size_t OUTPUT_BIAS = OUTPUT_WEIGHTS + 2 * NNUE_HIDDEN;
+    static constexpr size_t PARAMETER_COUNT = OUTPUT_BIAS + 1;
+
+    /**
+     * Accumulate the loss gradient of a range of positions.
+     * @param positions the positions
+     * @param count number of positions
+     * @param gradient gradient to add to
+     * @return Summed loss of the positions.
+     */
+    double _accumulate_gradient(const PackedPosition* positions, size_t count, float* gradient) const;
+
+    /**
+     * Sum the thread gradients and apply an Adam step to a range of parameters.
+     * @param begin first parameter
+     * @param end one past the last parameter
+     * @param gradient_count number of thread gradients to sum
+     * @param gradient_scale factor applied to the summed gradient
+     */
+    void _adam_step(size_t begin, size_t end, size_t gradient_count, float gradient_scale);
+
+    /**
+     * Compute the hidden layer pre-activations of a position.
+     * @param position the position
+     * @param hidden output, [side to move / other side][hidden]
+     * @param features output feature indices, [side to move / other side][32]
+     * @param feature_counts output feature counts
+     */
+    void _forward_hidden(const PackedPosition& position, float (*hidden)[NNUE_HIDDEN],
+                         int (*features)[32], int* feature_counts) const;
+
+    NnueTrainerConfig m_config;
+    float m_learning_rate;
+    uint64_t m_step = 0;
+    std::vector<float> m_parameters;
+    std::vector<float> m_moment1;
+    std::vector<float> m_moment2;
+    std::vector<std::vector<float>> m_thread_gradients;
+};
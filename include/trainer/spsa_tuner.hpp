@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "engine/minimax_engine.hpp"
+#include "engine/search_parameters.hpp"
+
+struct SpsaConfig {
+    int iterations = 1000;            // planned number of iterations, sets the gain schedules
+    int game_pairs = 64;              // game pairs per iteration, each opening is played with both colors
+    int64_t nodes_per_move = 5000;    // fixed node limit of each move
+    int max_plies = 400;              // longer games are adjudicated as draws
+    int tt_size_megabytes = 2;        // transposition table size of each engine
+    int threads = 1;                  // concurrent games
+    double learning_rate = 0.002;     // r_end: final step size relative to the squared perturbation size
+    double alpha = 0.602;             // step size decay exponent
+    double gamma = 0.101;             // perturbation decay exponent
+    double stability = -1.0;          // A, 10% of the iterations if negative
+    uint64_t seed = 1;
+};
+
+/**
+ * Outcome of one SPSA iteration from the perspective of the positively perturbed parameters.
+ */
+struct SpsaResult {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+};
+
+/**
+ * Read opening positions from an EPD file, one position per line. A trailing ';' and any operations are ignored.
+ * @param path path to the file
+ * @return The positions.
+ * @throw std::runtime_error if the file cannot be read or has no positions.
+ */
+std::vector<FEN> load_openings(const std::string& path);
+
+/**
+ * Play a game between two engines from a given position. The game ends by checkmate, stalemate,
+ * the fifty-move rule, threefold repetition or insufficient material. It is adjudicated as a win
+ * once both engines agree on a score of at least 1000 cp for four plies, and as a draw after max_plies.
+ * @param white engine playing white
+ * @param black engine playing black
+ * @param opening the starting position
+ * @param max_plies maximum game length
+ * @return The result from white's perspective, 1.0, 0.5 or 0.0.
+ */
+double play_game(MinimaxAI& white, MinimaxAI& black, const FEN& opening, int max_plies);
+
+/**
+ * SPSA tuner for the search parameters.
+ *
+ * Each iteration perturbs every parameter randomly up or down by its step, and plays game pairs between
+ * the two perturbed parameter sets with fixed node limits. The match result is a gradient estimate
+ * along the perturbation, and the parameters move along it. The step sizes follow the usual
+ * SPSA schedules, a_k = a / (A + k)^alpha and c_k = c / k^gamma, scaled so that the perturbation equals
+ * the parameter step and the step size equals learning_rate * step^2 at the last iteration.
+ */
+class SpsaTuner {
+public:
+    /**
+     * @param config tuning parameters
+     * @param start the starting parameters
+     */
+    explicit SpsaTuner(const SpsaConfig& config, const SearchParameters& start = SearchParameters{});
+    ~SpsaTuner();
+
+    /**
+     * Load the opening positions from an EPD file.
+     * @param path path to the file
+     * @return Number of positions loaded.
+     * @throw std::runtime_error if the file cannot be read or has no positions.
+     */
+    size_t load_openings(const std::string& path);
+
+    /**
+     * Set the opening positions.
+     * @param openings the positions
+     */
+    void set_openings(std::vector<FEN> openings);
+
+    /**
+     * Run one iteration: play the game pairs concurrently and update the parameters.
+     * @return The match result of the positively perturbed parameters.
+     * @throw std::runtime_error if there are no openings.
+     */
+    SpsaResult step();
+
+    /**
+     * @return Number of iterations done.
+     */
+    int iteration() const;
+
+    /**
+     * @return The current parameters, rounded to integers.
+     */
+    SearchParameters parameters() const;
+
+    /**
+     * @return The current unrounded parameter values, in the order of SearchParameters::table().
+     */
+    const std::vector<double>& values() const;
+
+private:
+    // Round and clamp values to a parameter set
+    SearchParameters _to_parameters(const std::vector<double>& values) const;
+
+    SpsaConfig m_config;
+    std::vector<double> m_values;
+    std::vector<FEN> m_openings;
+    int m_iteration = 0;
+    std::mt19937_64 m_rng;
+
+    // Two engines per thread, reused between games
+    std::vector<std::unique_ptr<MinimaxAI>> m_engines;
+};
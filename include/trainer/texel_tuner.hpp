@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/position.hpp"
+
+struct TexelTunerConfig {
+    int iterations = 2000;
+    double learning_rate = 1.0;  // Adam step size in centipawns
+    double k = 0.0;              // sigmoid scaling constant, fitted to the data before tuning if 0
+    int threads = 1;
+    int report_interval = 100;   // iterations between progress lines
+};
+
+/**
+ * One tunable constant or constant array of value_tables.hpp, flattened in declaration order.
+ */
+struct TunedTable {
+    std::string name;
+    std::vector<double> values;
+    std::vector<bool> tuned; // false for entries that are kept fixed
+};
+
+/**
+ * Parse a labelled EPD line. The result may be given as c9 "1-0", [1.0] or a bare 1-0 / 0-1 / 1/2-1/2 token.
+ * @param line the line
+ * @param fen output FEN of the position (board, side, castling and en passant fields)
+ * @param result output game result from white's perspective, 1.0, 0.5 or 0.0
+ * @return True if the line has a position and a result.
+ */
+bool parse_epd_line(const std::string& line, FEN& fen, double& result);
+
+/**
+ * Texel tuner for the hand-crafted evaluation weights in value_tables.hpp.
+ *
+ * With the game phase, endgame scale factor and king attacker count fixed per position, the evaluation
+ * is linear in the weights. Each position is reduced once to a sparse vector of per-weight coefficients,
+ * so an iteration is a sparse dot product per position instead of a full evaluation.
+ * The weights are then fitted with Adam to minimize the mean squared error between the game result
+ * and sigmoid(k * eval / 400).
+ */
+class TexelTuner {
+public:
+    /**
+     * Create a tuner starting from the current values in value_tables.hpp.
+     * @param config tuning parameters
+     */
+    explicit TexelTuner(const TexelTunerConfig& config);
+
+    /**
+     * Load labelled positions from an EPD file. Each position is resolved to a quiet position
+     * through a quiescence search and its coefficients are precomputed.
+     * Lines without a result, positions that are mate at the end of the search are skipped.
+     * @param path path to the file
+     * @param limit maximum number of positions to load
+     * @return Number of positions loaded.
+     * @throw std::runtime_error if the file cannot be read.
+     */
+    size_t load_epd(const std::string& path, size_t limit = std::numeric_limits<size_t>::max());
+
+    /**
+     * Add a labelled position as is, without the quiescence search.
+     * @param position the position
+     * @param result game result from white's perspective
+     */
+    void add_position(const Position& position, double result);
+
+    /**
+     * @return Number of loaded positions.
+     */
+    size_t position_count() const;
+
+    /**
+     * Fit the sigmoid scaling constant k to the loaded positions with the current weights.
+     * @return The fitted constant, also used for further tuning.
+     */
+    double fit_scaling_constant();
+
+    /**
+     * @return Mean squared error over the loaded positions with the current weights.
+     */
+    double loss() const;
+
+    /**
+     * Run the configured number of Adam iterations over the loaded positions. Progress is printed to stdout.
+     */
+    void tune();
+
+    /**
+     * Evaluate a position with the current weights using the linear model.
+     * @param position the position
+     * @return Evaluation in centipawns from white's perspective.
+     */
+    double evaluate(const Position& position) const;
+
+    /**
+     * @return The tuned tables with the current weights.
+     */
+    const std::vector<TunedTable>& tables() const;
+
+    /**
+     * Replace the initializers of the tuned constants in a copy of value_tables.hpp with the current weights,
+     * rounded to integers. Layout and comments are kept.
+     * @param header_text contents of value_tables.hpp
+     * @return The regenerated header.
+     * @throw std::runtime_error if a tuned constant is missing or has a different number of values.
+     */
+    std::string regenerate_header(const std::string& header_text) const;
+
+private:
+    struct Entry {
+        uint32_t begin;  // first coefficient
+        uint16_t count;  // number of coefficients
+        float result;
+    };
+
+    /**
+     * Compute the sparse coefficient vector of a position with the current weights.
+     * @param position the position
+     * @param coefficients output (parameter index, coefficient) pairs, such that the eval from white's
+     *                     perspective is the sum of coefficient * parameter
+     */
+    void _coefficients(const Position& position, std::vector<std::pair<uint16_t, float>>& coefficients) const;
+
+    /**
+     * Sum of a per-thread function over ranges of the loaded positions.
+     * @param function called with (thread index, first entry, one past the last entry), returns the partial sum
+     * @return Sum of the partial sums.
+     */
+    template<typename Function>
+    double _parallel_sum(Function&& function) const;
+
+    /**
+     * @param entry a loaded position
+     * @return Linear evaluation of the position with the current weights.
+     */
+    double _linear_eval(const Entry& entry) const;
+
+    TexelTunerConfig m_config;
+    double m_k;
+    std::vector<TunedTable> m_tables;
+    std::vector<size_t> m_offsets;    // first parameter index of each table
+    std::vector<double> m_parameters; // all table values, flattened
+    std::vector<bool> m_tuned;
+
+    std::vector<Entry> m_entries;
+    std::vector<uint16_t> m_indices;
+    std::vector<float> m_values;
+};
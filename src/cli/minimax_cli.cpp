@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -61,7 +62,17 @@ int main(int argc, char** argv) {
             if (cmd == "uci") {
                 std::cout << "id name MyMinimax \n";
                 std::cout << "id author Haapiainen\n";
-                std::cout << "uciok\n" << std::flush;
+                std::cout << "option name Threads type spin default 1 min 1 max " << MAX_SEARCH_THREADS << "\n";
+                std::cout << "option name PinThreads type check default false\n";
+                std::cout << "option name EvalFile type string default <empty>\n";
+                const SearchParameters defaults;
+                for (const SearchParameters::Info& info : SearchParameters::table()) {
+                    std::cout << "option name " << info.name << " type spin default " << defaults.*info.member
+                              << " min " << info.min << " max " << info.max << "\n";
+                }
+                std::cout << "uciok\n";
+                std::cout << "info string Hash uses " << to_string(engine->get_tt_page_backing())
+                          << ", attack tables use " << to_string(get_attack_table_page_backing()) << "\n" << std::flush;
             }
             else if (cmd == "isready") {
                 std::cout << "readyok\n" << std::flush;
@@ -128,7 +139,59 @@ int main(int argc, char** argv) {
                 stop_compute_and_busy_wait();
             }
             else if (cmd == "setoption") {
-                // ignore for now
+                // format: setoption name <id> [value <x>]
+                std::string token, name, value;
+                iss >> token;
+                if (token != "name")
+                    throw std::invalid_argument("Unknown setoption command format!");
+                while (iss >> token && token != "value")
+                    name += (name.empty() ? "" : " ") + token;
+                std::getline(iss >> std::ws, value); // string values such as paths may contain spaces
+                value.erase(value.find_last_not_of(" \t\r") + 1);
+
+                if (name == "Threads") {
+                    stop_compute_and_busy_wait();
+                    engine->set_threads(std::stoi(value));
+                }
+                else if (name == "PinThreads") {
+                    stop_compute_and_busy_wait();
+                    engine->set_thread_pinning(value == "true");
+                }
+                else if (name == "EvalFile") {
+                    stop_compute_and_busy_wait();
+                    engine->set_eval_file(value == "<empty>" ? "" : value);
+                    std::cout << "info string Using " << (value.empty() || value == "<empty>" ? "hand-crafted evaluation" : "NNUE " + value)
+                              << "\n" << std::flush;
+                }
+                else {
+                    // tunable search parameters, other options (Hash, Ponder, ...) are ignored without touching the search
+                    const auto& table = SearchParameters::table();
+                    const bool is_parameter = std::any_of(table.begin(), table.end(),
+                                                          [&](const SearchParameters::Info& info) { return name == info.name; });
+                    if (is_parameter) {
+                        SearchParameters params = engine->get_search_parameters();
+                        params.set(name, std::stoi(value)); // invalid values throw before the search is stopped
+                        stop_compute_and_busy_wait();
+                        engine->set_search_parameters(params);
+                    }
+                }
+            }
+            else if (cmd == "savehash" || cmd == "loadhash") {
+                // non-standard, format: savehash <path> | loadhash <path> [nochecksum]
+                std::string path, flag;
+                iss >> path >> flag;
+                if (path.empty())
+                    throw std::invalid_argument("Missing file path!");
+
+                stop_compute_and_busy_wait();
+                if (cmd == "savehash") {
+                    engine->save_transposition_table(path);
+                    std::cout << "info string Hash saved to " << path << "\n" << std::flush;
+                }
+                else {
+                    engine->load_transposition_table(path, flag != "nochecksum");
+                    std::cout << "info string Hash loaded from " << path << "\n" << std::flush;
+                }
             }
             else if (cmd == "quit") {
                 break;
@@ -28,7 +28,7 @@ uint64_t ROOK_MAGIC[64];
 uint64_t BISHOP_MAGIC[64];
 Bitboard MASK_ROOK_MAGIC[64];
 Bitboard MASK_BISHOP_MAGIC[64];
-Bitboard ROOK_ATTACK_TABLE[64][4096];
+HUGE_PAGE_ALIGNED Bitboard ROOK_ATTACK_TABLE[64][4096];
 Bitboard BISHOP_ATTACK_TABLE[64][512];
 
 Bitboard MASK_CASTLE_CLEAR[2][2];
@@ -39,6 +39,8 @@ uint64_t ZOBRIST_CASTLING[16];
 uint64_t ZOBRIST_EP[8];
 uint64_t ZOBRIST_SIDE;
 
+static PageBacking attack_table_page_backing = PageBacking::Normal;
+
 struct Initializer {
     Initializer() { init_bitboards(); }
 };
@@ -157,6 +159,10 @@ static void create_attack_table(Square sq) {
     }
 }
 
+PageBacking get_attack_table_page_backing() {
+    return attack_table_page_backing;
+}
+
 static void zero_tables() {
     std::memset(MASK_SQUARE, 0, sizeof(MASK_SQUARE));
     std::memset(MASK_BETWEEN, 0, sizeof(MASK_BETWEEN));
@@ -191,6 +197,8 @@ static void zero_tables() {
 }
 
 void init_bitboards() {
+    // Advise before first touch, so that the table is faulted in as a single huge page
+    attack_table_page_backing = advise_huge_pages(ROOK_ATTACK_TABLE, sizeof(ROOK_ATTACK_TABLE));
     zero_tables();
 
     // Single square masks
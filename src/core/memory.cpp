@@ -0,0 +1,175 @@
+#include "core/memory.hpp"
+
+#include <new>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+static size_t round_up(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+const char* to_string(PageBacking backing) {
+    switch (backing) {
+        case PageBacking::ExplicitHuge:    return "explicit huge pages";
+        case PageBacking::TransparentHuge: return "transparent huge pages";
+        case PageBacking::MappedFile:      return "memory mapped file";
+        default:                           return "normal pages";
+    }
+}
+
+#if defined(__linux__)
+
+// Transparent huge pages can be disabled system wide, in which case madvise still succeeds
+static bool transparent_huge_pages_enabled() {
+    static const bool enabled = [] {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string mode;
+        return std::getline(file, mode) && mode.find("[never]") == std::string::npos;
+    }();
+    return enabled;
+}
+
+PageBacking advise_huge_pages(void* ptr, size_t bytes) {
+    if (reinterpret_cast<uintptr_t>(ptr) % HUGE_PAGE_SIZE != 0 || bytes < HUGE_PAGE_SIZE)
+        return PageBacking::Normal;
+    if (madvise(ptr, round_up(bytes, HUGE_PAGE_SIZE), MADV_HUGEPAGE) != 0 || !transparent_huge_pages_enabled())
+        return PageBacking::Normal;
+    return PageBacking::TransparentHuge;
+}
+
+void* allocate_large_pages(size_t bytes, PageBacking& backing) {
+    const size_t size = round_up(bytes == 0 ? 1 : bytes, HUGE_PAGE_SIZE);
+
+    // Explicit huge pages, only available if the system has reserved them (vm.nr_hugepages)
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr != MAP_FAILED) {
+        backing = PageBacking::ExplicitHuge;
+        return ptr;
+    }
+
+    // Over-allocate to align the start to a huge page boundary, then unmap the excess
+    char* raw = static_cast<char*>(mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED)
+        throw std::bad_alloc();
+
+    char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+    if (aligned != raw)
+        munmap(raw, aligned - raw);
+    if (aligned + size != raw + size + HUGE_PAGE_SIZE)
+        munmap(aligned + size, raw + HUGE_PAGE_SIZE - aligned);
+
+    backing = advise_huge_pages(aligned, size);
+    return aligned;
+}
+
+void free_large_pages(void* ptr, size_t bytes) {
+    if (ptr)
+        munmap(ptr, round_up(bytes == 0 ? 1 : bytes, HUGE_PAGE_SIZE));
+}
+
+void* map_file_pages(const std::string& path, size_t offset, size_t bytes) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("map_file_pages() - cannot open file: " + path);
+
+    // Reserve the same sized region as allocate_large_pages, so that free_large_pages unmaps all of it
+    const size_t size = round_up(bytes == 0 ? 1 : bytes, HUGE_PAGE_SIZE);
+    void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        close(fd);
+        throw std::bad_alloc();
+    }
+
+    void* mapped = bytes == 0 ? region : mmap(region, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, static_cast<off_t>(offset));
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        munmap(region, size);
+        throw std::runtime_error("map_file_pages() - cannot map file: " + path);
+    }
+    return region;
+}
+
+static void clear_range(char* ptr, size_t bytes) {
+    // Private anonymous pages read back as zero after being released, and are committed again only when touched.
+    // Allocations are whole huge pages and ranges start at huge page boundaries, so rounding up stays inside the mapping.
+    if (madvise(ptr, round_up(bytes, HUGE_PAGE_SIZE), MADV_DONTNEED) != 0)
+        std::memset(ptr, 0, bytes);
+}
+
+#else
+
+static constexpr size_t FALLBACK_ALIGNMENT = 4096;
+
+PageBacking advise_huge_pages(void*, size_t) {
+    return PageBacking::Normal;
+}
+
+// calloc gets large blocks directly from OS zero pages, so nothing is touched here.
+// The original pointer is stored just before the aligned block for freeing.
+void* allocate_large_pages(size_t bytes, PageBacking& backing) {
+    const size_t size = round_up(bytes == 0 ? 1 : bytes, FALLBACK_ALIGNMENT);
+    void* raw = std::calloc(size + FALLBACK_ALIGNMENT, 1);
+    if (!raw)
+        throw std::bad_alloc();
+
+    void** aligned = reinterpret_cast<void**>(round_up(reinterpret_cast<uintptr_t>(raw) + sizeof(void*), FALLBACK_ALIGNMENT));
+    aligned[-1] = raw;
+    backing = PageBacking::Normal;
+    return aligned;
+}
+
+void free_large_pages(void* ptr, size_t) {
+    if (ptr)
+        std::free(static_cast<void**>(ptr)[-1]);
+}
+
+void* map_file_pages(const std::string& path, size_t offset, size_t bytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("map_file_pages() - cannot open file: " + path);
+
+    PageBacking backing;
+    void* ptr = allocate_large_pages(bytes, backing);
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(static_cast<char*>(ptr), static_cast<std::streamsize>(bytes))) {
+        free_large_pages(ptr, bytes);
+        throw std::runtime_error("map_file_pages() - cannot read file: " + path);
+    }
+    return ptr;
+}
+
+static void clear_range(char* ptr, size_t bytes) {
+    std::memset(ptr, 0, bytes);
+}
+
+#endif
+
+void clear_large_pages(void* ptr, size_t bytes, size_t thread_count) {
+    if (!ptr || bytes == 0) return;
+
+    // Split into huge page aligned chunks, one per thread
+    const size_t chunk = round_up((bytes + thread_count - 1) / std::max<size_t>(thread_count, 1), HUGE_PAGE_SIZE);
+    char* const begin = static_cast<char*>(ptr);
+    if (chunk >= bytes) {
+        clear_range(begin, bytes);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t offset = 0; offset < bytes; offset += chunk)
+        threads.emplace_back(clear_range, begin + offset, std::min(chunk, bytes - offset));
+    for (std::thread& thread : threads)
+        thread.join();
+}
@@ -0,0 +1,131 @@
+#include "core/numa.hpp"
+
+#include <vector>
+
+#if defined(__linux__)
+    #include <fstream>
+    #include <sstream>
+    #include <string>
+    #include <sched.h>
+    #include <unistd.h>
+    #include <sys/syscall.h>
+#endif
+
+#if defined(__linux__)
+
+static constexpr int MPOL_INTERLEAVE_MODE = 3; // MPOL_INTERLEAVE in <linux/mempolicy.h>
+static constexpr size_t MAX_NUMA_NODES = 1024;
+
+// Parse a kernel cpu/node list such as "0-3,8-11"
+static std::vector<int> parse_list(const std::string& path) {
+    std::vector<int> values;
+    std::ifstream file(path);
+    std::string list;
+    if (!std::getline(file, list))
+        return values;
+
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        const size_t dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int value = first; value <= last; ++value)
+            values.push_back(value);
+    }
+    return values;
+}
+
+static const std::vector<int>& online_nodes() {
+    static const std::vector<int> nodes = [] {
+        std::vector<int> nodes = parse_list("/sys/devices/system/node/online");
+        return nodes.empty() ? std::vector<int>{0} : nodes;
+    }();
+    return nodes;
+}
+
+// CPUs in pinning order: first CPU of each node, then the second CPU of each node, and so on
+static const std::vector<int>& pinning_order() {
+    static const std::vector<int> order = [] {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            return std::vector<int>{};
+
+        std::vector<std::vector<int>> node_cpus;
+        for (int node : online_nodes()) {
+            std::vector<int> cpus;
+            for (int cpu : parse_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                    cpus.push_back(cpu);
+            if (!cpus.empty())
+                node_cpus.push_back(cpus);
+        }
+
+        // No NUMA information, use the allowed CPUs as is
+        if (node_cpus.empty()) {
+            node_cpus.emplace_back();
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &allowed))
+                    node_cpus.back().push_back(cpu);
+        }
+
+        std::vector<int> order;
+        for (size_t i = 0; ; ++i) {
+            const size_t size_before = order.size();
+            for (const std::vector<int>& cpus : node_cpus)
+                if (i < cpus.size())
+                    order.push_back(cpus[i]);
+            if (order.size() == size_before)
+                break;
+        }
+        return order;
+    }();
+    return order;
+}
+
+size_t numa_node_count() {
+    return online_nodes().size();
+}
+
+bool interleave_numa_nodes(void* ptr, size_t bytes) {
+    if (numa_node_count() < 2 || ptr == nullptr || bytes == 0)
+        return false;
+
+    constexpr size_t BITS_PER_WORD = 8 * sizeof(unsigned long);
+    unsigned long node_mask[MAX_NUMA_NODES / BITS_PER_WORD] = {};
+    for (int node : online_nodes())
+        if (node >= 0 && static_cast<size_t>(node) < MAX_NUMA_NODES)
+            node_mask[node / BITS_PER_WORD] |= 1UL << (node % BITS_PER_WORD);
+
+    // The kernel reads maxnode - 1 bits of the mask
+    return syscall(SYS_mbind, ptr, bytes, MPOL_INTERLEAVE_MODE, node_mask, MAX_NUMA_NODES + 1, 0) == 0;
+}
+
+bool pin_thread(size_t thread_index) {
+    const std::vector<int>& order = pinning_order();
+    if (order.empty())
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(order[thread_index % order.size()], &cpu_set);
+    return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+#else
+
+size_t numa_node_count() {
+    return 1;
+}
+
+bool interleave_numa_nodes(void*, size_t) {
+    return false;
+}
+
+bool pin_thread(size_t) {
+    return false;
+}
+
+#endif
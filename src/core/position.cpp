@@ -4,7 +4,7 @@
 #include <sstream>
 
 Position::StoredState::StoredState(Move move, Piece captured_piece, uint8_t castling_rights,
-            Square en_passant_square, uint8_t halfmoves, uint64_t key, uint64_t pawn_key,
+            Square en_passant_square, uint8_t halfmoves, uint64_t key, uint64_t pawn_key, uint64_t material_key,
             std::array<Bitboard, 2> king_blockers, std::array<Bitboard, 2> pinners,
             std::array<bool, 2> pins_computed) 
   : move(move),
@@ -13,6 +13,7 @@ Position::StoredState::StoredState(Move move, Piece captured_piece, uint8_t cast
     en_passant_square(en_passant_square),
     key(key),
     pawn_key(pawn_key),
+    material_key(material_key),
     halfmoves(halfmoves),
     king_blockers(king_blockers),
     pinners(pinners),
@@ -36,6 +37,9 @@ Position::Position(const Position& other, bool copy_history) {
     m_en_passant_square = other.m_en_passant_square;
     m_halfmoves = other.m_halfmoves;
     m_fullmoves = other.m_fullmoves;
+    m_key = other.m_key;
+    m_pawn_key = other.m_pawn_key;
+    m_material_key = other.m_material_key;
 
     if (copy_history) {
         m_state_history = other.m_state_history;
@@ -215,6 +219,14 @@ void Position::from_fen(const FEN& fen) {
     // Compute Zobrist hashes for current position
     m_key = 0ULL;
     m_pawn_key = ZOBRIST_SIDE; // ensures that the key is never zero, but side is not part of the hash
+    m_material_key = 0ULL;     // never zero, kings are always counted
+    for (Color color : {Color::White, Color::Black}) {
+        for (int type = 0; type < 6; type++) {
+            const int count = popcount(get_pieces(color, PieceType(type)));
+            for (int i = 0; i < count; i++)
+                m_material_key ^= ZOBRIST_PIECE[+create_piece(color, PieceType(type))][i];
+        }
+    }
     for(int sq = 0; sq < 64; sq++) {
         Piece piece = get_piece_at(Square(sq));
         assert(piece != Piece::All);
@@ -354,6 +366,49 @@ bool Position::gives_check(Move move) const {
     return false;
 }
 
+uint64_t Position::key_after(Move move) const {
+    const Square from = MoveEncoding::from_sq(move);
+    const Square to = MoveEncoding::to_sq(move);
+    const MoveType move_type = MoveEncoding::move_type(move);
+    const Piece moved_piece = get_piece_at(from);
+
+    uint64_t key = m_key ^ ZOBRIST_SIDE;
+    key ^= (m_en_passant_square != Square::None) * ZOBRIST_EP[+file_of(m_en_passant_square)];
+
+    // Captured piece (handling en passant)
+    const Square capture_square = move_type == MoveType::EnPassant ? to - pawn_dir(m_side_to_move) : to;
+    const Piece captured = get_piece_at(capture_square);
+    if (captured != Piece::None)
+        key ^= ZOBRIST_PIECE[+captured][+capture_square];
+
+    // Moved piece / promotion
+    key ^= ZOBRIST_PIECE[+moved_piece][+from];
+    if (move_type == MoveType::Promotion) {
+        key ^= ZOBRIST_PIECE[+create_piece(m_side_to_move, MoveEncoding::promo(move))][+to];
+    }
+    else {
+        key ^= ZOBRIST_PIECE[+moved_piece][+to];
+        if (to_type(moved_piece) == PieceType::Pawn && std::abs(int(to) - int(from)) == 16)
+            key ^= ZOBRIST_EP[+file_of(from + pawn_dir(m_side_to_move))];
+    }
+
+    // Castling rook
+    if (move_type == MoveType::Castle) {
+        const Square rook_from = to > from ? from + 3 : from - 4;
+        const Square rook_to = static_cast<Square>((+to + +from) >> 1); // to + from / 2
+        const Piece rook = create_piece(m_side_to_move, PieceType::Rook);
+        key ^= ZOBRIST_PIECE[+rook][+rook_from] ^ ZOBRIST_PIECE[+rook][+rook_to];
+    }
+
+    // Castling rights
+    if (m_castling_rights & (MASK_CASTLE_FLAG[+from] | MASK_CASTLE_FLAG[+to])) {
+        key ^= ZOBRIST_CASTLING[m_castling_rights & 0x0F];
+        key ^= ZOBRIST_CASTLING[m_castling_rights & ~(MASK_CASTLE_FLAG[+from] | MASK_CASTLE_FLAG[+to]) & 0x0F];
+    }
+
+    return key;
+}
+
 void Position::make_move(Move move) {
     const Color opp = opponent(m_side_to_move);
     const Square from = MoveEncoding::from_sq(move);
@@ -378,7 +433,7 @@ void Position::make_move(Move move) {
 
     // Store state to history
     m_state_history.emplace_back(StoredState(move, captured, m_castling_rights, m_en_passant_square,
-                                    m_halfmoves, m_key, m_pawn_key, m_king_blockers, m_pinners, m_pins_computed));
+                                    m_halfmoves, m_key, m_pawn_key, m_material_key, m_king_blockers, m_pinners, m_pins_computed));
 
     // Update move counters
     m_halfmoves++;
@@ -408,6 +463,7 @@ void Position::make_move(Move move) {
         m_pieces_by_color[+opp] &= ~MASK_SQUARE[+capture_square];
         m_piece_on_square[+capture_square] = Piece::None;
         m_key ^= ZOBRIST_PIECE[+captured][+capture_square];
+        m_material_key ^= ZOBRIST_PIECE[+captured][popcount(get_pieces(opp, to_type(captured)))];
         m_halfmoves = 0; // reset on capture
     }
 
@@ -421,6 +477,8 @@ void Position::make_move(Move move) {
         m_piece_on_square[+to] = promo_piece;
         m_key ^= ZOBRIST_PIECE[+promo_piece][+to];
         m_pawn_key ^= ZOBRIST_PIECE[+moved_piece][+from];
+        m_material_key ^= ZOBRIST_PIECE[+moved_piece][popcount(get_pieces(m_side_to_move, PieceType::Pawn))]
+                        ^ ZOBRIST_PIECE[+promo_piece][popcount(get_pieces(m_side_to_move, promo)) - 1];
     }
     else {
         m_pieces_by_type[+to_type(moved_piece)] |= MASK_SQUARE[+to];
@@ -532,6 +590,7 @@ bool Position::undo_move() {
     // restore hashes
     m_key = state.key;
     m_pawn_key = state.pawn_key;
+    m_material_key = state.material_key;
 
     // restore pinners and blockers state
     std::memcpy(&m_king_blockers, &state.king_blockers, sizeof(m_king_blockers));
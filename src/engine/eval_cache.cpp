@@ -0,0 +1,49 @@
+#include "engine/eval_cache.hpp"
+
+static inline uint32_t key_check(uint64_t key, uint64_t salt) {
+    return static_cast<uint32_t>((key ^ salt) >> 32);
+}
+
+EvalCache::EvalCache(size_t megabytes) {
+    size_t bytes = megabytes * 1024ULL * 1024ULL;
+    size_t n = bytes / sizeof(EvalCacheEntry);
+
+    // power of two size
+    size_t pow2 = 16ULL;
+    while (pow2 * 2 <= n) pow2 *= 2;
+    m_table = LargePageArray<EvalCacheEntry>(pow2);
+    m_mask = pow2 - 1;
+
+    // A zeroed entry would match keys with an all zero upper half, start from a salted generation
+    clear();
+}
+
+void EvalCache::clear() {
+    m_salt = generation_salt(++m_generation);
+}
+
+void EvalCache::wipe(size_t thread_count) {
+    m_table.clear(thread_count);
+    clear();
+}
+
+const EvalCacheEntry* EvalCache::find(uint64_t key) {
+    const EvalCacheEntry& entry = m_table[key & m_mask];
+    if (entry.key_check == key_check(key, m_salt)) {
+        ++m_hits;
+        return &entry;
+    }
+    ++m_misses;
+    return nullptr;
+}
+
+void EvalCache::store(uint64_t key, int32_t eval) {
+    EvalCacheEntry& entry = m_table[key & m_mask];
+    entry.key_check = key_check(key, m_salt);
+    entry.eval = eval;
+}
+
+void EvalCache::reset_counters() {
+    m_hits = 0;
+    m_misses = 0;
+}
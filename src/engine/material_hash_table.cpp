@@ -0,0 +1,36 @@
+#include "engine/material_hash_table.hpp"
+
+MaterialHashTable::MaterialHashTable(size_t megabytes) {
+    size_t bytes = megabytes * 1024ULL * 1024ULL;
+    size_t n = bytes / sizeof(MaterialTableEntry);
+
+    // power of two size
+    size_t pow2 = 16ULL;
+    while (pow2 * 2 <= n) pow2 *= 2;
+    m_table = LargePageArray<MaterialTableEntry>(pow2);
+    m_mask = pow2 - 1;
+}
+
+void MaterialHashTable::clear() {
+    m_salt = generation_salt(++m_generation);
+}
+
+void MaterialHashTable::wipe(size_t thread_count) {
+    m_table.clear(thread_count);
+    m_generation = 0;
+    m_salt = 0;
+}
+
+const MaterialTableEntry* MaterialHashTable::find(uint64_t key) const {
+    size_t idx = key & m_mask;
+    if (m_table[idx].key == (key ^ m_salt))
+        return &m_table[idx];
+    return nullptr;
+}
+
+const MaterialTableEntry* MaterialHashTable::store(uint64_t key, const MaterialTableEntry& entry) {
+    size_t idx = key & m_mask;
+    m_table[idx] = entry;
+    m_table[idx].key = key ^ m_salt;
+    return &m_table[idx];
+}
@@ -3,10 +3,12 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <thread>
 
 #include "engine/move_picker.hpp"
 #include "engine/value_tables.hpp"
 #include "engine/see.hpp"
+#include "core/numa.hpp"
 
 static constexpr int32_t NO_SCORE = 111'111'111;
 static constexpr int32_t INF_SCORE = 100'000'000;
@@ -19,21 +21,29 @@ static inline int32_t now_milliseconds() {
     return static_cast<int32_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
 }
 
-// Adjust a score to be stored in the TT (mate distance encoding)
-static inline int32_t normalize_score_for_tt(int32_t score, int ply) {
+// Mate scores are stored in the TT relative to this value, so that all scores fit in 16 bits
+static constexpr int32_t TT_MATE_SCORE = 32'000;
+static constexpr int32_t TT_MATE_OFFSET = MATE_SCORE - TT_MATE_SCORE;
+
+// TT depths of quiescence search entries. In check all evasions are searched, so the result is worth more.
+static constexpr int16_t TT_DEPTH_QS_CHECKS = 0;
+static constexpr int16_t TT_DEPTH_QS_NO_CHECKS = -1;
+
+// Adjust a score to be stored in the TT (mate distance encoding, 16-bit range)
+static inline int16_t normalize_score_for_tt(int32_t score, int ply) {
     if (score > MATE_SCORE - 1000)
-        return score + ply;
+        return static_cast<int16_t>(score + ply - TT_MATE_OFFSET);
     if (score < -MATE_SCORE + 1000)
-        return score - ply;
-    return score;
+        return static_cast<int16_t>(score - ply + TT_MATE_OFFSET);
+    return static_cast<int16_t>(std::clamp(score, -TT_MATE_SCORE + 1000, TT_MATE_SCORE - 1000));
 }
 
 // Adjust a stored TT score back to the current ply (mate distance decoding)
-static inline int32_t adjust_score_from_tt(int32_t stored_score, int ply) {
-    if (stored_score > MATE_SCORE - 1000)
-        return stored_score - ply;
-    if (stored_score < -MATE_SCORE + 1000)
-        return stored_score + ply;
+static inline int32_t adjust_score_from_tt(int16_t stored_score, int ply) {
+    if (stored_score > TT_MATE_SCORE - 1000)
+        return stored_score + TT_MATE_OFFSET - ply;
+    if (stored_score < -TT_MATE_SCORE + 1000)
+        return stored_score - TT_MATE_OFFSET + ply;
     return stored_score;
 }
 
@@ -90,6 +100,9 @@ void registerMinimaxAI() {
         {"time_limit", "Thinking time (s)", FieldType::Double, 5.0},
         {"max_depth", "Maximum search depth", FieldType::Int, 99},
         {"tt_size_megabytes", "Transposition table size (MB)", FieldType::Int, 256},
+        {"threads", "Search threads", FieldType::Int, 1},
+        {"pin_threads", "Pin search threads to CPUs", FieldType::Bool, false},
+        {"eval_file", "NNUE network file (empty for hand-crafted eval)", FieldType::String, std::string()},
     };
 
     AIRegistry::registerAI("Minimax", cfg, createMinimaxAI);
@@ -100,9 +113,14 @@ MinimaxAI::MinimaxAI(const std::vector<ConfigField>& cfg)
     m_time_limit_seconds(get_config_field_value<double>(cfg, "time_limit")),
     m_tt_size_megabytes(get_config_field_value<int>(cfg, "tt_size_megabytes")),
     m_spos(),
-    m_tt(m_tt_size_megabytes),
+    m_tt(std::make_shared<TranspositionTable>(m_tt_size_megabytes)),
     m_enable_uci_output(get_config_field_value<bool>(cfg, "enable_uci_output"))
-{}
+{
+    set_threads(get_config_field_value<int>(cfg, "threads"));
+    set_thread_pinning(get_config_field_value<bool>(cfg, "pin_threads"));
+    set_eval_file(get_config_field_value<std::string>(cfg, "eval_file"));
+    _build_lmr_table();
+}
 
 MinimaxAI::MinimaxAI(const int32_t max_depth,
                     const double time_limit_seconds,
@@ -112,9 +130,22 @@ MinimaxAI::MinimaxAI(const int32_t max_depth,
     m_time_limit_seconds(time_limit_seconds),
     m_tt_size_megabytes(tt_size_megabytes),
     m_spos(),
-    m_tt(m_tt_size_megabytes),
+    m_tt(std::make_shared<TranspositionTable>(m_tt_size_megabytes)),
     m_enable_uci_output(enable_uci_output)
-{}
+{
+    _build_lmr_table();
+}
+
+MinimaxAI::MinimaxAI(MinimaxAI& main_search)
+  : m_tt_size_megabytes(main_search.m_tt_size_megabytes),
+    m_spos(),
+    m_tt(main_search.m_tt),
+    m_main_search(&main_search),
+    m_enable_uci_output(false)
+{
+    m_spos.set_nnue(main_search.m_nnue);
+    set_search_parameters(main_search.m_params);
+}
 
 void MinimaxAI::set_time_limit_seconds(double secs) {
     m_time_limit_seconds = secs < 0.0 ? 1e6 : secs;
@@ -125,8 +156,39 @@ void MinimaxAI::set_max_depth(int depth) {
 void MinimaxAI::set_max_nodes(int64_t nodes) {
     m_max_nodes = nodes < 0 ? std::numeric_limits<int64_t>::max() : nodes;
 }
+void MinimaxAI::set_threads(int threads) {
+    m_threads = std::clamp(threads, 1, MAX_SEARCH_THREADS);
+}
+void MinimaxAI::set_thread_pinning(bool enabled) {
+    m_pin_threads = enabled;
+}
+void MinimaxAI::set_eval_file(const std::string& path) {
+    m_nnue = path.empty() ? nullptr : NnueNetwork::load(path);
+    m_spos.set_nnue(m_nnue);
+    m_helpers.clear();  // recreated with the new network by the next search
+    m_tt->clear();      // stored static evals are from the previous evaluation
+}
+void MinimaxAI::set_search_parameters(const SearchParameters& params) {
+    m_params = params;
+    _build_lmr_table();
+}
+const SearchParameters& MinimaxAI::get_search_parameters() const {
+    return m_params;
+}
 void MinimaxAI::clear_transposition_table() {
-    m_tt.clear();
+    m_tt->clear();
+}
+
+PageBacking MinimaxAI::get_tt_page_backing() const {
+    return m_tt->page_backing();
+}
+
+void MinimaxAI::save_transposition_table(const std::string& path) const {
+    m_tt->save(path, m_spos.eval_fingerprint());
+}
+
+void MinimaxAI::load_transposition_table(const std::string& path, bool verify_checksum) {
+    m_tt->load(path, verify_checksum, m_spos.eval_fingerprint());
 }
 
 void MinimaxAI::Stats::reset() {
@@ -138,6 +200,11 @@ void MinimaxAI::Stats::reset() {
     tt_raw_hits = 0;
     tt_usable_hits = 0;
     tt_cutoffs = 0;
+    helper_nodes = 0;
+    eval_calls = 0;
+    tt_eval_hits = 0;
+    eval_cache_hits = 0;
+    eval_cache_misses = 0;
     eval = 0;
     time_seconds = 0.0;
 }
@@ -155,6 +222,10 @@ void MinimaxAI::Stats::print() const {
     std::cout << "   TT raw hit %: " << (double)tt_raw_hits / (double)alpha_beta_nodes * 100.0 << "\n";
     std::cout << "   TT usable hit %: " << (double)tt_usable_hits / (double)alpha_beta_nodes * 100.0 << "\n";
     std::cout << "   TT cutoff %: " << (double)tt_cutoffs / (double)alpha_beta_nodes * 100.0 << "\n";
+    std::cout << "   Helper thread nodes: " << helper_nodes << "\n";
+    std::cout << "   Static eval calls: " << eval_calls << "\n";
+    std::cout << "   Static evals from TT %: " << (double)tt_eval_hits / (double)(eval_calls + tt_eval_hits) * 100.0 << "\n";
+    std::cout << "   Eval cache hit %: " << (double)eval_cache_hits / (double)(eval_cache_hits + eval_cache_misses) * 100.0 << "\n";
 }
 
 auto MinimaxAI::get_stats() const -> Stats {
@@ -165,6 +236,10 @@ void MinimaxAI::_set_board(const FEN& fen) {
     m_killer_history.reset();
     m_move_history.reset();
     m_spos.set_board(fen);
+
+    m_root_fen = fen;
+    m_game_moves.clear();
+    m_helpers_synced = false;
 }
 
 void MinimaxAI::_apply_move(const UCI& uci_move) {
@@ -174,11 +249,64 @@ void MinimaxAI::_apply_move(const UCI& uci_move) {
     if (std::find(move_list.begin(), move_list.end(), move) == move_list.end())
         throw std::invalid_argument("MinimaxAI::apply_move() - illegal move!");
     m_spos.make_move(move);
+
+    m_game_moves.push_back(move);
+    m_helpers_synced = false;
 }
 
 void MinimaxAI::_undo_move() {
     if (!m_spos.undo_move())
         throw std::invalid_argument("MinimaxAI::undo_move() - no previous move!");
+
+    if (!m_game_moves.empty())
+        m_game_moves.pop_back();
+    m_helpers_synced = false;
+}
+
+void MinimaxAI::_sync_helpers() {
+    const size_t helper_count = static_cast<size_t>(m_threads - 1);
+    if (m_helpers.size() > helper_count)
+        m_helpers.resize(helper_count);
+    while (m_helpers.size() < helper_count) {
+        m_helpers.emplace_back(new MinimaxAI(*this));
+        m_helpers_synced = false;
+    }
+
+    if (m_helpers_synced)
+        return;
+
+    // Replay the game so that the helpers also see the repetition history
+    for (auto& helper : m_helpers) {
+        helper->_set_board(m_root_fen);
+        for (Move move : m_game_moves)
+            helper->m_spos.make_move(move);
+    }
+    m_helpers_synced = true;
+}
+
+void MinimaxAI::_helper_search(int thread_index) {
+    // The pawn hash table of the helper is first touched by its search, so it lands on the node of the pinned CPU
+    if (m_main_search->m_pin_threads)
+        pin_thread(static_cast<size_t>(thread_index));
+
+    m_stats.reset();
+    m_killer_history.reset();
+    m_stop_search = false;
+    m_nodes_visited = 0;
+    m_published_nodes.store(0, std::memory_order_relaxed);
+    m_seldepth = 0;
+
+    // Odd helpers start one ply deeper, so that the threads desynchronize
+    // and spread out to different parts of the tree sooner.
+    for (int target_depth = 1 + (thread_index & 1); target_depth <= m_max_depth; ++target_depth) {
+        m_root_best_move = NO_MOVE;
+        m_root_best_score = -INF_SCORE;
+        _reset_search_stack();
+        _alpha_beta<NodeType::Root>(-INF_SCORE, INF_SCORE, target_depth, 0);
+
+        if (m_stop_search)
+            break;
+    }
 }
 
 std::pair<int, UCI> MinimaxAI::find_mate() {
@@ -194,7 +322,8 @@ UCI MinimaxAI::_compute_move() {
 
     // Prepare next search
     m_stats.reset();
-    m_tt.new_search_iteration();
+    m_spos.reset_eval_cache_counters();
+    m_tt->new_search_iteration();
     m_killer_history.reset();
 
     m_start_time = now_milliseconds();
@@ -202,6 +331,22 @@ UCI MinimaxAI::_compute_move() {
     m_stop_search = false;
     m_nodes_visited = 0;
     m_seldepth = 0;
+
+    // Lazy SMP: helpers run their own iterative deepening on the same position.
+    // They communicate with the main search only through the shared transposition table.
+    _sync_helpers();
+    m_helpers_stop = false;
+    std::vector<std::thread> helper_threads;
+    helper_threads.reserve(m_helpers.size());
+    for (size_t i = 0; i < m_helpers.size(); ++i) {
+        MinimaxAI& helper = *m_helpers[i];
+        helper.m_max_depth = m_max_depth;
+        if (!(helper.m_params == m_params))
+            helper.set_search_parameters(m_params);
+        helper.m_start_time = m_start_time;
+        helper.m_deadline = m_deadline;
+        helper_threads.emplace_back(&MinimaxAI::_helper_search, &helper, static_cast<int>(i + 1));
+    }
     
     Move best_move = NO_MOVE;
     int32_t best_score = -INF_SCORE;
@@ -215,6 +360,7 @@ UCI MinimaxAI::_compute_move() {
         // Normal search
         m_root_best_move = NO_MOVE;
         m_root_best_score = -INF_SCORE;
+        _reset_search_stack();
         _alpha_beta<NodeType::Root>(-INF_SCORE, INF_SCORE, target_depth, 0);
 
         if (m_stop_search) {
@@ -235,12 +381,13 @@ UCI MinimaxAI::_compute_move() {
             std::cout << "info depth " << target_depth << " seldepth " << m_seldepth << " score ";
             if (is_decisive(m_root_best_score)) std::cout << "mate " << to_mate_distance(m_root_best_score);
             else std::cout << "cp " << m_root_best_score;
-            std::cout << " nodes " << m_stats.alpha_beta_nodes
-                    << " nps " << (time_elapsed == 0 ? "inf" : std::to_string(static_cast<int>(static_cast<double>(m_stats.alpha_beta_nodes + m_stats.quiescence_nodes) / time_elapsed * 1000.0)))
+            const int64_t nodes = _total_nodes();
+            std::cout << " nodes " << nodes
+                    << " nps " << (time_elapsed == 0 ? "inf" : std::to_string(static_cast<int64_t>(static_cast<double>(nodes) / time_elapsed * 1000.0)))
                     << " time " << time_elapsed << " pv ";
             int pv_length = 0;
             for (size_t i = 0; i < target_depth; ++i) {
-                const TTEntry* tt_entry = m_tt.find(m_spos.get_position().get_key());
+                const std::optional<TTEntry> tt_entry = m_tt->find(m_spos.get_position().get_key());
                 if (!tt_entry || tt_entry->best_move == NO_MOVE)
                     break;
                 std::cout << MoveEncoding::to_uci(tt_entry->best_move) << " ";
@@ -253,6 +400,13 @@ UCI MinimaxAI::_compute_move() {
         }
     }
 
+    // Stop and collect helpers
+    m_helpers_stop = true;
+    for (std::thread& thread : helper_threads)
+        thread.join();
+    for (auto& helper : m_helpers)
+        m_stats.helper_nodes += helper->m_stats.alpha_beta_nodes + helper->m_stats.quiescence_nodes;
+
     if (best_move == NO_MOVE) {
         if (target_depth != 1)
             throw std::runtime_error("MinimaxAI::_compute_move() - missing move result!");
@@ -265,6 +419,8 @@ UCI MinimaxAI::_compute_move() {
 
     m_stats.depth = target_depth - 1;
     m_stats.eval = best_score;
+    m_stats.eval_cache_hits = m_spos.get_eval_cache().hits();
+    m_stats.eval_cache_misses = m_spos.get_eval_cache().misses();
     m_stats.time_seconds = static_cast<double>(now_milliseconds() - m_start_time) / 1000.0;
 
     UCI uci_best_move = MoveEncoding::to_uci(best_move);
@@ -276,7 +432,7 @@ UCI MinimaxAI::_compute_move() {
 
 
 template<NodeType node_type>
-int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth, const int32_t ply, const int32_t prior_reductions) {
+int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth, const int32_t ply) {
     constexpr bool is_root = (node_type == NodeType::Root);
     constexpr bool is_pv = (node_type == NodeType::PV || is_root);
 
@@ -300,16 +456,23 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
     if (depth <= 0)
         return _quiescence(alpha, beta, ply);
 
+    // Search stack is full, just evaluate
+    if (ply >= MAX_SEARCH_PLY)
+        return m_spos.get_eval();
+
+    SearchFrame* const ss = _frame(ply);
+    const Move excluded_move = ss->excluded_move; // set when verifying that the TT move is singular
+
     ++m_stats.alpha_beta_nodes;
     int32_t starting_alpha = alpha;
 
     // Probe transposition table
     uint64_t zobrist_key = m_spos.get_position().get_key();
-    const TTEntry* tt_entry = m_tt.find(zobrist_key);
+    const std::optional<TTEntry> tt_entry = m_tt->find(zobrist_key);
     if (tt_entry) ++m_stats.tt_raw_hits;
 
-    // Check for cutoffs from TT entry
-    if (!is_pv && tt_entry && tt_entry->depth >= depth) {
+    // Check for cutoffs from TT entry. The entry does not apply when a move is excluded.
+    if (!is_pv && excluded_move == NO_MOVE && tt_entry && tt_entry->depth >= depth) {
         ++m_stats.tt_usable_hits;
         int32_t stored = adjust_score_from_tt(tt_entry->score, ply);
 
@@ -325,8 +488,39 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
         }
     }
 
-    int32_t static_eval = m_spos.get_eval();
+    int32_t static_eval = _static_eval(tt_entry);
     const bool in_check = m_spos.get_position().in_check();
+    ss->static_eval = in_check ? SEARCH_EVAL_NONE : static_eval;
+    ss->in_check = in_check;
+    (ss + 1)->excluded_move = NO_MOVE;
+
+    // The position is improving if the static eval is higher than on our previous move,
+    // or the one before it if we were in check then. Pruning is more aggressive when not improving.
+    bool improving = false;
+    if (!in_check) {
+        if ((ss - 2)->static_eval != SEARCH_EVAL_NONE)
+            improving = static_eval > (ss - 2)->static_eval;
+        else if ((ss - 4)->static_eval != SEARCH_EVAL_NONE)
+            improving = static_eval > (ss - 4)->static_eval;
+    }
+
+    // Reverse futility pruning (static null move pruning)
+    // If the static eval is above beta by a depth dependent margin, assume that some move keeps it above beta.
+    if (!is_pv && !in_check && excluded_move == NO_MOVE && m_params.rfp_enabled && depth <= m_params.rfp_max_depth && !is_decisive(beta)
+        && static_eval - m_params.rfp_depth_margin * (depth - improving) >= beta)
+        return static_eval;
+
+    // Razoring
+    // If the static eval is far below alpha at low depth, only a tactic could save the node.
+    // Let the quiescence search decide, and trust a fail-low from it.
+    if (!is_pv && !in_check && excluded_move == NO_MOVE && m_params.razoring_enabled && depth <= m_params.razor_max_depth && !is_decisive(alpha)
+        && static_eval + m_params.razor_base_margin + m_params.razor_depth_margin * depth * depth <= alpha) {
+        const int32_t score = _quiescence(alpha, alpha + 1, ply);
+        if (m_stop_search)
+            return NO_SCORE;
+        if (score <= alpha)
+            return score;
+    }
 
     // Null move pruning
     // If the static eval is high enough, do a null move (pass the turn) and see if we still get a a beta cutoff (with much reduced depth).
@@ -335,10 +529,14 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
     // The is_null_window and previous_was_capture conditions are some ideas, that can improve tactical stability.
     bool is_null_window = !is_pv && alpha == beta - 1;
     bool previous_was_capture = m_spos.get_position().get_last_move_capture() != Piece::None;
-    if (!is_root && (is_null_window || !previous_was_capture) && !in_check && depth >= 3 && has_non_pawn_material(m_spos.get_position()) && static_eval >= 13 + beta) {
+    if (!is_root && excluded_move == NO_MOVE && (is_null_window || !previous_was_capture) && !in_check && depth >= 3
+        && has_non_pawn_material(m_spos.get_position())
+        && static_eval >= m_params.null_move_margin + beta) {
+        ss->current_move = NO_MOVE;
+        (ss + 1)->reductions = ss->reductions;
         m_spos.make_null_move();
-        const int32_t R = 3 + (depth >= 8); // reduction
-        int32_t score = -_alpha_beta<NodeType::NonPV>(-beta - 1, -beta, depth - 1 - R, ply + 1, prior_reductions);
+        const int32_t R = m_params.null_move_reduction + (depth >= m_params.null_move_deep_depth); // reduction
+        int32_t score = -_alpha_beta<NodeType::NonPV>(-beta - 1, -beta, depth - 1 - R, ply + 1);
         m_spos.undo_null_move();
 
         if (m_stop_search)
@@ -355,8 +553,8 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
     int32_t best_score = -INF_SCORE;
     int move_count = 0;
 
-    MovePicker move_picker(m_spos.get_position(), ply, tt_entry ? tt_entry->best_move : NO_MOVE,
-                            &m_killer_history, &m_move_history);
+    const Move tt_move = tt_entry ? tt_entry->best_move : NO_MOVE;
+    MovePicker move_picker(m_spos.get_position(), ply, tt_move, &m_killer_history, &m_move_history, excluded_move);
     for (Move move = move_picker.next(); move != NO_MOVE; move = move_picker.next()) {
         ++move_count;
         if (is_root && m_enable_uci_output && now_milliseconds() - m_start_time >= 5000) {
@@ -368,14 +566,34 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
         const bool gives_check = m_spos.get_position().gives_check(move);
         const bool is_capture = m_spos.get_position().to_capture(move) != PieceType::None;
         const bool is_promotion = MoveEncoding::move_type(move) == MoveType::Promotion;
+        const int32_t history = m_move_history.get(m_spos.get_position(), move);
+        const bool is_quiet = !is_capture && !is_promotion;
+
+        // Shallow-depth pruning of quiet moves, once there is a move that does not lose
+        if (!is_root && !in_check && is_quiet && !gives_check && move_count > 1 && !is_loss(best_score)) {
+            // Late move pruning
+            // With good move ordering, the last quiets rarely matter at low depth. After enough moves skip them all.
+            if (!is_pv && m_params.lmp_enabled && depth <= m_params.lmp_max_depth
+                && move_count >= (m_params.lmp_base + depth * depth) / (improving ? 1 : 2)) {
+                move_picker.skip_quiets();
+                continue;
+            }
+
+            // SEE pruning
+            // Quiet moves that lose material in the exchange on the target square are unlikely to be good.
+            if (m_params.see_quiet_pruning_enabled && depth <= m_params.see_quiet_max_depth
+                && !static_exchange_evaluation(m_spos.get_position(), move, -m_params.see_quiet_margin * depth))
+                continue;
+        }
 
         // Futility pruning
         // If the static eval is lower than alpha by a certain futility margin, we can just prune the move without searching it.
         // For tactical stability this is not done when in check, or when the move gives check or is a capture/promotion.
-        if (can_futility_prune && move_count > 1 && !gives_check && !is_promotion && !is_capture && !is_decisive(alpha)) {
-            int32_t futility_value = static_eval + 48; // base margin
-                                    + depth * 91       // depth based margin
-                                    + m_move_history.get(m_spos.get_position(), move) / 32; // history bonus
+        if (can_futility_prune && move_count > 1 && !gives_check && is_quiet && !is_decisive(alpha)) {
+            int32_t futility_value = static_eval + m_params.futility_base_margin  // base margin
+                                    + depth * m_params.futility_depth_margin       // depth based margin
+                                    + history / m_params.futility_history_divisor  // history bonus
+                                    - (improving ? 0 : m_params.futility_improving_margin);
             if (futility_value <= alpha) {
                 if (best_score < futility_value && !is_decisive(best_score)) {
                     best_score = futility_value;
@@ -385,11 +603,39 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
             }
         }
 
+        // Singular extension
+        // If the TT move failed high at nearly this depth, search the other moves with a reduced depth and a window below the TT score.
+        // If they all fail low, the TT move is the only good move and is extended.
+        // If they fail high and the window is at or above beta, several moves beat beta and the node is cut (multi-cut).
+        int32_t extension = 0;
+        if (!is_root && m_params.singular_enabled && move == tt_move && excluded_move == NO_MOVE
+            && depth >= m_params.singular_min_depth && tt_entry->bound == Bound::Lower
+            && tt_entry->depth >= depth - m_params.singular_tt_depth_margin) {
+            const int32_t tt_score = adjust_score_from_tt(tt_entry->score, ply);
+            if (!is_decisive(tt_score)) {
+                const int32_t singular_beta = tt_score - m_params.singular_beta_margin * depth;
+                ss->excluded_move = move;
+                const int32_t score = _alpha_beta<NodeType::NonPV>(singular_beta - 1, singular_beta, (depth - 1) / 2, ply);
+                ss->excluded_move = NO_MOVE;
+
+                if (m_stop_search)
+                    return NO_SCORE;
+
+                if (score < singular_beta)
+                    extension = 1;
+                else if (singular_beta >= beta)
+                    return singular_beta;
+            }
+        }
+
         // Check extension for moves with good SEE values
-        if (gives_check && static_exchange_evaluation(m_spos.get_position(), move, 0))
-            new_depth += 1;
+        if (extension == 0 && gives_check && static_exchange_evaluation(m_spos.get_position(), move, 0))
+            extension = 1;
+        new_depth += extension;
 
-        // make move
+        // make move, the child TT cluster is fetched while the move and eval updates are done
+        m_tt->prefetch(m_spos.get_position().key_after(move));
+        ss->current_move = move;
         m_spos.make_move(move);
         int32_t score;
 
@@ -398,7 +644,8 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
         // while other moves are searched with a null window first to try to fail-low quickly.
         // In case a null window search fails high, we re-search with a full window, as it is the new PV.
         if (is_pv && move_count == 1) {
-            // Search first move with full window
+            // Search first move with full window, reductions are counted again from the PV
+            (ss + 1)->reductions = 0;
             score = -_alpha_beta<NodeType::PV>(-beta, -alpha, new_depth, ply + 1);
         }
         else {
@@ -409,27 +656,35 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
             int32_t reductions = 0;
             const bool lmr = !is_root && move_count >= 3 && new_depth >= 3;
             if (lmr) {
-                // Formula idea from https://www.chessprogramming.org/Late_Move_Reductions
-                reductions += 1 + static_cast<int32_t>(floorf(logf(new_depth) * logf(move_count) / 3.2f));
+                reductions = _lmr_reduction(is_pv, new_depth, move_count);
+
+                // Quiet moves with a good history are reduced less, bad ones more
+                if (!is_capture && !is_promotion)
+                    reductions -= history / m_params.lmr_history_divisor;
+                if (!improving)
+                    reductions += m_params.lmr_not_improving;
 
-                // limit total reductions to 3
-                reductions = std::min(reductions, 3 - prior_reductions);
+                // limit total reductions, and never extend
+                reductions = std::clamp(reductions, 0, std::max(0, m_params.lmr_max_reduction - ss->reductions));
             }
 
             // Null window search with possible LMR
-            score = -_alpha_beta<NodeType::NonPV>(-alpha - 1, -alpha, new_depth - reductions, ply + 1, prior_reductions + reductions);
+            (ss + 1)->reductions = ss->reductions + reductions;
+            score = -_alpha_beta<NodeType::NonPV>(-alpha - 1, -alpha, new_depth - reductions, ply + 1);
 
             // Check if re-search is needed with LMR. Search first the full depth with a null window.
             // So assume for now the move failed high due to LMR rather than actually being a new PV.
             // A null window search is still very cheap.
             if (lmr && score > alpha && score < beta && !m_stop_search) {
-                score = -_alpha_beta<NodeType::NonPV>(-alpha - 1, -alpha, new_depth, ply + 1, prior_reductions);
+                (ss + 1)->reductions = ss->reductions;
+                score = -_alpha_beta<NodeType::NonPV>(-alpha - 1, -alpha, new_depth, ply + 1);
             }
 
             // Check if re-search is needed with null-window. If the full depth null window search failed high,
             // we need to re-search with a full window, as it is the new PV.
             if (score > alpha && score < beta && !m_stop_search) {
-                score = -_alpha_beta<NodeType::PV>(-beta, -alpha, new_depth, ply + 1, prior_reductions);
+                (ss + 1)->reductions = ss->reductions;
+                score = -_alpha_beta<NodeType::PV>(-beta, -alpha, new_depth, ply + 1);
             }
         }
 
@@ -482,19 +737,23 @@ int32_t MinimaxAI::_alpha_beta(int32_t alpha, int32_t beta, const int32_t depth,
         }
     }
 
-    // Check for checkmate or stalemate
+    // Check for checkmate or stalemate. With a move excluded, the excluded move is the only move and so singular.
     if (move_count == 0) {
-        best_score = in_check ? mated_in(ply) : DRAW_SCORE;
+        best_score = excluded_move != NO_MOVE ? alpha : in_check ? mated_in(ply) : DRAW_SCORE;
     }
 
     assert(best_score > -INF_SCORE && best_score < INF_SCORE);
 
+    // The result of a search with an excluded move is not the value of the position
+    if (excluded_move != NO_MOVE)
+        return best_score;
+
     // Store the result in the transposition table
-    int32_t store_score = normalize_score_for_tt(best_score, ply);
+    int16_t store_score = normalize_score_for_tt(best_score, ply);
     Bound bound = (best_score <= starting_alpha) ? Bound::Upper
                             : (best_score >= beta) ? Bound::Lower
                                                     : Bound::Exact;
-    m_tt.store(zobrist_key, store_score, depth, bound, best_move);
+    m_tt->store(zobrist_key, store_score, depth, bound, best_move, static_eval);
 
     return best_score;
 }
@@ -505,7 +764,30 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
     if (_stop_check())
         return NO_SCORE;
 
-    const int32_t static_eval = m_spos.get_eval();
+    // Search stack is full, just evaluate
+    if (ply >= MAX_SEARCH_PLY)
+        return m_spos.get_eval();
+
+    const int32_t starting_alpha = alpha;
+    const bool in_check = m_spos.get_position().in_check();
+    const int16_t tt_depth = in_check ? TT_DEPTH_QS_CHECKS : TT_DEPTH_QS_NO_CHECKS;
+
+    // Probe transposition table
+    // Any entry from the main search, or a quiescence entry of the same kind, is deep enough for a cutoff.
+    const uint64_t zobrist_key = m_spos.get_position().get_key();
+    const std::optional<TTEntry> tt_entry = m_tt->find(zobrist_key);
+    if (tt_entry && tt_entry->depth >= tt_depth) {
+        int32_t stored = adjust_score_from_tt(tt_entry->score, ply);
+        if (tt_entry->bound == Bound::Exact
+            || (tt_entry->bound == Bound::Lower && stored >= beta)
+            || (tt_entry->bound == Bound::Upper && stored <= alpha))
+            return stored;
+    }
+
+    const int32_t static_eval = _static_eval(tt_entry);
+    SearchFrame* const ss = _frame(ply);
+    ss->static_eval = in_check ? SEARCH_EVAL_NONE : static_eval;
+    ss->in_check = in_check;
 
     // Delta pruning before move generation
     // If even a big capture added to the static eval cannot raise alpha,
@@ -517,15 +799,17 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
         return alpha;
 
     int32_t best_score = -INF_SCORE;
+    Move best_move = NO_MOVE;
 
-    const bool in_check = m_spos.get_position().in_check();
     if (!in_check) {
         // Standing pat evaluation
         // When not in check we can assume that at least one quiet move does not worsen the position.
         // This is based on the null move observation, and does not hold only in rare zugzwang positions.
         // Therefore, we can consider the static eval as the minimum score.
-        if (static_eval >= beta)
+        if (static_eval >= beta) {
+            m_tt->store(zobrist_key, normalize_score_for_tt(static_eval, ply), tt_depth, Bound::Lower, NO_MOVE, static_eval);
             return static_eval;
+        }
         if (static_eval > alpha)
             alpha = static_eval;
         best_score = static_eval;
@@ -533,7 +817,7 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
 
     const int32_t material_phase = m_spos.material_phase();
 
-    MovePicker move_picker(m_spos.get_position(), NO_MOVE, &m_move_history);
+    MovePicker move_picker(m_spos.get_position(), tt_entry ? tt_entry->best_move : NO_MOVE, &m_move_history);
     int move_count = 0;
 
     for (Move move = move_picker.next(); move != NO_MOVE; move = move_picker.next()) {
@@ -541,7 +825,7 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
 
         // More delta pruning, disabled in endgame
         if (!in_check && material_phase > PHASE_LATE_ENDGAME) {
-            int32_t delta_value =  static_eval + 150 + PIECE_VALUES[+m_spos.get_position().to_capture(move)];
+            int32_t delta_value =  static_eval + m_params.delta_margin + PIECE_VALUES[+m_spos.get_position().to_capture(move)];
             if (MoveEncoding::move_type(move) == MoveType::Promotion)
                 delta_value += PIECE_VALUES[+PieceType::Queen] - PIECE_VALUES[+PieceType::Pawn];
             if (delta_value <= alpha) {
@@ -551,6 +835,8 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
             }
         }
 
+        m_tt->prefetch(m_spos.get_position().key_after(move));
+        ss->current_move = move;
         m_spos.make_move(move);
         int32_t score = -_quiescence(-beta, -alpha, ply + 1);
         m_spos.undo_move();
@@ -565,6 +851,7 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
             best_score = score;
 
             if (score > alpha) {
+                best_move = move;
                 if (score < beta) {
                     alpha = score;
                 }
@@ -582,15 +869,69 @@ inline int32_t MinimaxAI::_quiescence(int32_t alpha, int32_t beta, const int32_t
         best_score = mated_in(ply);
 
     assert(best_score > -INF_SCORE && best_score < INF_SCORE);
+
+    // Store the result in the transposition table
+    Bound bound = (best_score <= starting_alpha) ? Bound::Upper
+                            : (best_score >= beta) ? Bound::Lower
+                                                    : Bound::Exact;
+    m_tt->store(zobrist_key, normalize_score_for_tt(best_score, ply), tt_depth, bound, best_move, static_eval);
+
     return best_score;
 }
 
+void MinimaxAI::_build_lmr_table() {
+    // Formula idea from https://www.chessprogramming.org/Late_Move_Reductions
+    for (int is_pv = 0; is_pv < 2; ++is_pv) {
+        const float base = (is_pv ? m_params.lmr_base_pv : m_params.lmr_base) / 100.0f;
+        const float divisor = (is_pv ? m_params.lmr_divisor_pv : m_params.lmr_divisor) / 100.0f;
+        for (int depth = 0; depth < LMR_TABLE_SIZE; ++depth) {
+            for (int move_count = 0; move_count < LMR_TABLE_SIZE; ++move_count) {
+                const float reduction = depth == 0 || move_count == 0 ? 0.0f
+                                      : base + logf(depth) * logf(move_count) / divisor;
+                m_lmr_table[is_pv][depth][move_count] = static_cast<int8_t>(std::clamp(floorf(reduction), 0.0f, 100.0f));
+            }
+        }
+    }
+}
+
+inline int32_t MinimaxAI::_lmr_reduction(bool is_pv, int32_t depth, int32_t move_count) const {
+    return m_lmr_table[is_pv][std::min(depth, LMR_TABLE_SIZE - 1)][std::min(move_count, LMR_TABLE_SIZE - 1)];
+}
+
+inline int32_t MinimaxAI::_static_eval(const std::optional<TTEntry>& tt_entry) {
+    if (tt_entry && tt_entry->eval != TT_EVAL_NONE) {
+        ++m_stats.tt_eval_hits;
+        return tt_entry->eval;
+    }
+    ++m_stats.eval_calls;
+    return m_spos.get_eval();
+}
+
+inline SearchFrame* MinimaxAI::_frame(int32_t ply) {
+    assert(ply >= -4 && ply < MAX_SEARCH_PLY + 1);
+    return &m_search_stack[ply + 4];
+}
+
+void MinimaxAI::_reset_search_stack() {
+    m_search_stack.fill(SearchFrame{});
+}
+
+int64_t MinimaxAI::_total_nodes() const {
+    int64_t nodes = static_cast<int64_t>(m_stats.alpha_beta_nodes + m_stats.quiescence_nodes);
+    for (const auto& helper : m_helpers)
+        nodes += helper->m_published_nodes.load(std::memory_order_relaxed);
+    return nodes;
+}
+
 inline bool MinimaxAI::_stop_check() {
     constexpr int64_t mask = (1<<10) - 1; // every 1024 nodes
     if ((++m_nodes_visited & mask) == 0) {
+        if (m_main_search)
+            m_published_nodes.store(m_nodes_visited, std::memory_order_relaxed);
         if (now_milliseconds() >= m_deadline
             || (m_max_nodes >= 0 && m_nodes_visited >= m_max_nodes)
-            || _stop_requested()) {
+            || _stop_requested()
+            || (m_main_search && m_main_search->m_helpers_stop.load(std::memory_order_relaxed))) {
             m_stop_search = true;
         }
     }
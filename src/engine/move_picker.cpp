@@ -13,10 +13,12 @@ static inline void insertion_sort(ScoredMove* begin, ScoredMove* end) {
     }
 }
 
-MovePicker::MovePicker(const Position& position, int ply, const Move tt_move, KillerHistory* killer_history, MoveHistory* move_history)
+MovePicker::MovePicker(const Position& position, int ply, const Move tt_move, KillerHistory* killer_history, MoveHistory* move_history,
+                       const Move excluded_move)
   : m_position(position),
     m_ply(ply),
     m_tt_move(tt_move),
+    m_excluded_move(excluded_move),
     m_killer_history(killer_history),
     m_move_history(move_history),
     m_scored_moves{},
@@ -40,7 +42,6 @@ MovePicker::MovePicker(const Position& position, const Move tt_move, MoveHistory
     m_scored_moves{},
     m_cur_begin(m_scored_moves.data())
 {
-    // TT move not used in quiescence search
     if (m_position.in_check())
         m_stage = MovePickStage::TTMoveEvasion;
     else {
@@ -70,6 +71,14 @@ void MovePicker::repick_quiets() {
 }
 
 Move MovePicker::next() {
+    // Every move is picked at most once, so one more pick skips the excluded move
+    Move move = pick();
+    if (move != NO_MOVE && move == m_excluded_move)
+        move = pick();
+    return move;
+}
+
+Move MovePicker::pick() {
     switch (m_stage) {
         case MovePickStage::TTMoveNormal:
         case MovePickStage::TTMoveEvasion:
@@ -112,19 +121,21 @@ Move MovePicker::next() {
 
         case MovePickStage::FirstKillerMove: {
             Move killer = m_killer_history->first(m_ply);
-            if (++m_stage; killer != NO_MOVE && killer != m_tt_move && test_legality(m_position, killer))
+            if (++m_stage; killer != NO_MOVE && killer != m_tt_move && test_legality(m_position, killer)
+                && (!m_skip_quiets || m_position.gives_check(killer)))
                 return killer;
         }
         [[fallthrough]];
 
         case MovePickStage::SecondKillerMove: {
             Move killer = m_killer_history->second(m_ply);
-            if (++m_stage; killer != NO_MOVE && killer != m_tt_move && test_legality(m_position, killer))
+            if (++m_stage; killer != NO_MOVE && killer != m_tt_move && test_legality(m_position, killer)
+                && (!m_skip_quiets || m_position.gives_check(killer)))
                 return killer;
         }
         [[fallthrough]];
 
-        case MovePickStage::ScoreQuiets: if (!m_skip_quiets) {
+        case MovePickStage::ScoreQuiets: {
             MoveList quiets;
             quiets.generate<GenerateType::Quiets>(m_position);
             m_cur_end = score_moves<GenerateType::Quiets>(quiets, m_cur_begin);
@@ -135,11 +146,12 @@ Move MovePicker::next() {
         }
         [[fallthrough]];
 
-        case MovePickStage::Quiets: if (!m_skip_quiets) {
+        case MovePickStage::Quiets: {
             while (m_cur_begin < m_cur_end) {
                 if (m_cur_begin->move == m_tt_move
                     || m_cur_begin->move == m_killer_history->first(m_ply)
-                    || m_cur_begin->move == m_killer_history->second(m_ply)) {
+                    || m_cur_begin->move == m_killer_history->second(m_ply)
+                    || (m_skip_quiets && !m_position.gives_check(m_cur_begin->move))) {
                     ++m_cur_begin;
                     continue;
                 }
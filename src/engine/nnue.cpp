@@ -0,0 +1,205 @@
+#include "engine/nnue.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Network file layout (native byte order):
+// FileHeader, followed by feature weights, feature biases, output weights and output bias as in memory
+static constexpr char FILE_MAGIC[8] = {'C', 'B', 'O', 'T', 'N', 'N', 'U', 'E'};
+static constexpr uint32_t FILE_VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t inputs;
+    uint32_t hidden;
+    int32_t qa;
+    int32_t qb;
+    int32_t eval_scale;
+    uint64_t data_checksum;
+};
+
+static uint64_t checksum(const void* ptr, size_t bytes, uint64_t hash = 0) {
+    const uint8_t* data = static_cast<const uint8_t*>(ptr);
+    for (size_t i = 0; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ULL + (hash >> 29);
+    }
+    for (size_t i = bytes & ~size_t(7); i < bytes; ++i)
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+// Parameters are stored contiguously from feature_weights up to and including output_bias
+static constexpr size_t DATA_BYTES = offsetof(NnueNetwork, output_bias) + sizeof(int32_t);
+
+std::shared_ptr<const NnueNetwork> NnueNetwork::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("NnueNetwork::load() - cannot open file: " + path);
+
+    FileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("NnueNetwork::load() - file too short: " + path);
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        throw std::runtime_error("NnueNetwork::load() - not a network file: " + path);
+    if (header.version != FILE_VERSION || header.inputs != NNUE_INPUTS || header.hidden != NNUE_HIDDEN
+        || header.qa != NNUE_QA || header.qb != NNUE_QB || header.eval_scale != NNUE_EVAL_SCALE)
+        throw std::runtime_error("NnueNetwork::load() - unsupported network architecture: " + path);
+
+    auto network = std::make_shared<NnueNetwork>();
+    if (!file.read(reinterpret_cast<char*>(network.get()), DATA_BYTES) || file.peek() != EOF)
+        throw std::runtime_error("NnueNetwork::load() - invalid file size: " + path);
+    if (header.data_checksum != network->checksum())
+        throw std::runtime_error("NnueNetwork::load() - data checksum mismatch: " + path);
+
+    return network;
+}
+
+uint64_t NnueNetwork::checksum() const {
+    return ::checksum(this, DATA_BYTES);
+}
+
+void NnueNetwork::save(const std::string& path) const {
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.inputs = NNUE_INPUTS;
+    header.hidden = NNUE_HIDDEN;
+    header.qa = NNUE_QA;
+    header.qb = NNUE_QB;
+    header.eval_scale = NNUE_EVAL_SCALE;
+    header.data_checksum = checksum();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("NnueNetwork::save() - cannot open file: " + path);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(this), DATA_BYTES);
+    if (!file.flush())
+        throw std::runtime_error("NnueNetwork::save() - failed to write file: " + path);
+}
+
+#if defined(__AVX2__)
+
+// out = in + add - sub over one accumulator row, add or sub may be nullptr
+static inline void update_row(const int16_t* in, int16_t* out, const int16_t* add, const int16_t* sub) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i));
+        if (add)
+            v = _mm256_add_epi16(v, _mm256_load_si256(reinterpret_cast<const __m256i*>(add + i)));
+        if (sub)
+            v = _mm256_sub_epi16(v, _mm256_load_si256(reinterpret_cast<const __m256i*>(sub + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+}
+
+// Sum over the hidden layer of clipped ReLU activations times output weights
+static inline int32_t output_sum(const int16_t* values, const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(NNUE_QA);
+    __m256i sum = zero;
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+        v = _mm256_min_epi16(_mm256_max_epi16(v, zero), qa);
+        const __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+    }
+    __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum128);
+}
+
+#elif defined(__SSE2__)
+
+static inline void update_row(const int16_t* in, int16_t* out, const int16_t* add, const int16_t* sub) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (add)
+            v = _mm_add_epi16(v, _mm_load_si128(reinterpret_cast<const __m128i*>(add + i)));
+        if (sub)
+            v = _mm_sub_epi16(v, _mm_load_si128(reinterpret_cast<const __m128i*>(sub + i)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + i), v);
+    }
+}
+
+static inline int32_t output_sum(const int16_t* values, const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa = _mm_set1_epi16(NNUE_QA);
+    __m128i sum = zero;
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(values + i));
+        v = _mm_min_epi16(_mm_max_epi16(v, zero), qa);
+        const __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(v, w));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+#else
+
+static inline void update_row(const int16_t* in, int16_t* out, const int16_t* add, const int16_t* sub) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+        out[i] = static_cast<int16_t>(in[i] + (add ? add[i] : 0) - (sub ? sub[i] : 0));
+}
+
+static inline int32_t output_sum(const int16_t* values, const int16_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        const int32_t v = values[i] < 0 ? 0 : (values[i] > NNUE_QA ? NNUE_QA : values[i]);
+        sum += v * weights[i];
+    }
+    return sum;
+}
+
+#endif
+
+void NnueNetwork::refresh(NnueAccumulator& accumulator, const Position& position) const {
+    for (Color perspective : {Color::White, Color::Black}) {
+        int16_t* values = accumulator.values[+perspective];
+        std::memcpy(values, feature_biases, sizeof(feature_biases));
+
+        Bitboard pieces = position.get_pieces();
+        while (pieces) {
+            const Square square = lsb(pieces);
+            update_row(values, values, feature_weights[nnue_feature_index(perspective, position.get_piece_at(square), square)], nullptr);
+            pop_lsb(pieces);
+        }
+    }
+    accumulator.valid = true;
+}
+
+void NnueNetwork::update(const NnueAccumulator& from, NnueAccumulator& to, const NnueFeatureDelta& delta) const {
+    // A move always removes the moved piece from its origin and places a piece on the target square,
+    // so the first add and remove are fused and the rest (capture, castling rook) applied in place
+    for (Color perspective : {Color::White, Color::Black}) {
+        int16_t* out = to.values[+perspective];
+        update_row(from.values[+perspective], out,
+                   feature_weights[nnue_feature_index(perspective, delta.added_pieces[0], delta.added_squares[0])],
+                   feature_weights[nnue_feature_index(perspective, delta.removed_pieces[0], delta.removed_squares[0])]);
+        for (int j = 1; j < std::max(delta.added_count, delta.removed_count); ++j) {
+            const int16_t* added = j < delta.added_count
+                ? feature_weights[nnue_feature_index(perspective, delta.added_pieces[j], delta.added_squares[j])] : nullptr;
+            const int16_t* removed = j < delta.removed_count
+                ? feature_weights[nnue_feature_index(perspective, delta.removed_pieces[j], delta.removed_squares[j])] : nullptr;
+            update_row(out, out, added, removed);
+        }
+    }
+    to.valid = true;
+}
+
+int32_t NnueNetwork::evaluate(const NnueAccumulator& accumulator, Color side_to_move) const {
+    const int32_t sum = output_sum(accumulator.values[+side_to_move], output_weights[0])
+                      + output_sum(accumulator.values[+opponent(side_to_move)], output_weights[1]);
+    return static_cast<int32_t>((static_cast<int64_t>(sum) + output_bias) * NNUE_EVAL_SCALE / (NNUE_QA * NNUE_QB));
+}
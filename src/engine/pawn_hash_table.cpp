@@ -7,24 +7,52 @@ PawnHashTable::PawnHashTable(size_t megabytes) {
     // power of two size
     size_t pow2 = 16ULL;
     while (pow2 * 2 <= n) pow2 *= 2;
-    m_table.resize(pow2);
+    m_table = LargePageArray<PawnTableEntry>(pow2);
     m_mask = pow2 - 1;
 }
 
 void PawnHashTable::clear() {
-    for (auto& entry : m_table)
-        entry.key = 0;
+    m_salt = generation_salt(++m_generation);
 }
 
-const PawnTableEntry* PawnHashTable::find(uint64_t key) const {
+void PawnHashTable::wipe(size_t thread_count) {
+    m_table.clear(thread_count);
+    m_generation = 0;
+    m_salt = 0;
+}
+
+PawnTableEntry* PawnHashTable::find(uint64_t key) {
     size_t idx = key & m_mask;
-    if (m_table[idx].key == key)
+    if (m_table[idx].key == (key ^ m_salt))
         return &m_table[idx];
     return nullptr;
 }
 
-void PawnHashTable::store(uint64_t key, int32_t eval) {
+PawnTableEntry* PawnHashTable::store(uint64_t key, const PawnTableEntry& entry) {
     size_t idx = key & m_mask;
-    m_table[idx].key = key;
-    m_table[idx].eval = eval;
+    m_table[idx] = entry;
+    m_table[idx].key = key ^ m_salt;
+    return &m_table[idx];
+}
+
+PawnTableEntry compute_pawn_sets(Bitboard w_pawns, Bitboard b_pawns) {
+    PawnTableEntry entry{};
+    entry.shield_king_square[+Color::White] = Square::None;
+    entry.shield_king_square[+Color::Black] = Square::None;
+
+    entry.pawn_attacks[+Color::White] = pawn_attacks<Color::White>(w_pawns);
+    entry.pawn_attacks[+Color::Black] = pawn_attacks<Color::Black>(b_pawns);
+    entry.attack_spans[+Color::White] = attack_front_spans<Color::White>(w_pawns);
+    entry.attack_spans[+Color::Black] = attack_front_spans<Color::Black>(b_pawns);
+
+    // Passed pawns: no opposing pawn in front or on the adjacent files in front, and no own pawn in front
+    const Bitboard w_blockers = entry.attack_spans[+Color::Black] | front_spans<Color::Black>(b_pawns);
+    const Bitboard b_blockers = entry.attack_spans[+Color::White] | front_spans<Color::White>(w_pawns);
+    entry.passed_pawns[+Color::White] = w_pawns & ~w_blockers & ~front_spans<Color::Black>(w_pawns);
+    entry.passed_pawns[+Color::Black] = b_pawns & ~b_blockers & ~front_spans<Color::White>(b_pawns);
+
+    // The first rank of a file fill has a bit for every file with pawns
+    entry.semi_open_files[+Color::White] = static_cast<uint8_t>(~file_fill(w_pawns));
+    entry.semi_open_files[+Color::Black] = static_cast<uint8_t>(~file_fill(b_pawns));
+    return entry;
 }
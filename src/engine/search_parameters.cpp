@@ -0,0 +1,96 @@
+#include "engine/search_parameters.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+const std::vector<SearchParameters::Info>& SearchParameters::table() {
+    static const std::vector<Info> parameters = {
+        {"null_move_margin",         &SearchParameters::null_move_margin,         -100, 200, 8.0},
+        {"null_move_reduction",      &SearchParameters::null_move_reduction,      1,    6,   0.5},
+        {"null_move_deep_depth",     &SearchParameters::null_move_deep_depth,     3,    16,  1.0},
+        {"futility_base_margin",     &SearchParameters::futility_base_margin,     0,    300, 10.0},
+        {"futility_depth_margin",    &SearchParameters::futility_depth_margin,    20,   300, 10.0},
+        {"futility_history_divisor", &SearchParameters::futility_history_divisor, 4,    256, 4.0},
+        {"futility_improving_margin",&SearchParameters::futility_improving_margin,0,    200, 8.0},
+        {"lmr_base",                 &SearchParameters::lmr_base,                 -100, 300, 10.0},
+        {"lmr_divisor",              &SearchParameters::lmr_divisor,              100,  800, 20.0},
+        {"lmr_base_pv",              &SearchParameters::lmr_base_pv,              -100, 300, 10.0},
+        {"lmr_divisor_pv",           &SearchParameters::lmr_divisor_pv,           100,  800, 20.0},
+        {"lmr_history_divisor",      &SearchParameters::lmr_history_divisor,      16,   40000, 50.0},
+        {"lmr_not_improving",        &SearchParameters::lmr_not_improving,        0,    3,   0.5},
+        {"lmr_max_reduction",        &SearchParameters::lmr_max_reduction,        1,    8,   0.5},
+        {"rfp_enabled",              &SearchParameters::rfp_enabled,              0,    1,   0.0},
+        {"rfp_max_depth",            &SearchParameters::rfp_max_depth,            0,    12,  1.0},
+        {"rfp_depth_margin",         &SearchParameters::rfp_depth_margin,         20,   300, 8.0},
+        {"razoring_enabled",         &SearchParameters::razoring_enabled,         0,    1,   0.0},
+        {"razor_max_depth",          &SearchParameters::razor_max_depth,          0,    8,   1.0},
+        {"razor_base_margin",        &SearchParameters::razor_base_margin,        0,    1000, 20.0},
+        {"razor_depth_margin",       &SearchParameters::razor_depth_margin,       0,    600, 15.0},
+        {"lmp_enabled",              &SearchParameters::lmp_enabled,              0,    1,   0.0},
+        {"lmp_max_depth",            &SearchParameters::lmp_max_depth,            0,    12,  1.0},
+        {"lmp_base",                 &SearchParameters::lmp_base,                 1,    20,  1.0},
+        {"see_quiet_pruning_enabled",&SearchParameters::see_quiet_pruning_enabled,0,    1,   0.0},
+        {"see_quiet_max_depth",      &SearchParameters::see_quiet_max_depth,      0,    12,  1.0},
+        {"see_quiet_margin",         &SearchParameters::see_quiet_margin,         0,    300, 8.0},
+        {"singular_enabled",         &SearchParameters::singular_enabled,         0,    1,   0.0},
+        {"singular_min_depth",       &SearchParameters::singular_min_depth,       4,    16,  1.0},
+        {"singular_tt_depth_margin", &SearchParameters::singular_tt_depth_margin, 0,    6,   0.5},
+        {"singular_beta_margin",     &SearchParameters::singular_beta_margin,     0,    16,  0.5},
+        {"delta_margin",             &SearchParameters::delta_margin,             0,    500, 15.0},
+    };
+    return parameters;
+}
+
+static const SearchParameters::Info& find_info(const std::string& name) {
+    const auto& parameters = SearchParameters::table();
+    auto it = std::find_if(parameters.begin(), parameters.end(), [&](const auto& info) { return name == info.name; });
+    if (it == parameters.end())
+        throw std::invalid_argument("SearchParameters - unknown parameter: " + name);
+    return *it;
+}
+
+int32_t SearchParameters::get(const std::string& name) const {
+    return this->*find_info(name).member;
+}
+
+void SearchParameters::set(const std::string& name, int32_t value) {
+    const Info& info = find_info(name);
+    if (value < info.min || value > info.max)
+        throw std::invalid_argument("SearchParameters::set() - value out of range for " + name + ": " + std::to_string(value));
+    this->*info.member = value;
+}
+
+std::string SearchParameters::to_string() const {
+    std::ostringstream oss;
+    for (const Info& info : table())
+        oss << info.name << " " << this->*info.member << "\n";
+    return oss.str();
+}
+
+SearchParameters SearchParameters::parse(const std::string& text) {
+    SearchParameters parameters;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream iss(line);
+        std::string name, extra;
+        int32_t value;
+        if (!(iss >> name) || name[0] == '#')
+            continue;
+        if (!(iss >> value) || (iss >> extra))
+            throw std::invalid_argument("SearchParameters::parse() - invalid line: " + line);
+        parameters.set(name, value);
+    }
+    return parameters;
+}
+
+SearchParameters SearchParameters::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("SearchParameters::load() - cannot open file: " + path);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return parse(contents.str());
+}
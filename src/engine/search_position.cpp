@@ -1,6 +1,8 @@
 #include "engine/search_position.hpp"
+#include <algorithm>
 #include <iostream>
-SearchPosition::SearchPosition() : m_position(), m_pawn_hash_table(32) {
+SearchPosition::SearchPosition(size_t eval_cache_megabytes)
+    : m_position(), m_pawn_hash_table(32), m_material_hash_table(1), m_eval_cache(eval_cache_megabytes) {
     m_base_evals.reserve(200);
     m_zobrist_history.reserve(200);
     m_irreversible_move_plies.reserve(50);
@@ -10,7 +12,10 @@ void SearchPosition::set_board(const FEN& fen) {
     m_position.from_fen(fen);
     m_base_evals.clear();
     m_base_evals.emplace_back(_compute_base_eval());
+    if (m_nnue)
+        m_nnue->refresh(m_accumulators[0], m_position);
     m_pawn_hash_table.clear();
+    m_material_hash_table.clear();
 
     m_zobrist_history.clear();
     m_irreversible_move_plies.clear();
@@ -18,31 +23,49 @@ void SearchPosition::set_board(const FEN& fen) {
 }
 
 int32_t SearchPosition::get_eval() const {
-    // Interpolate evaluation based on game phase
-    Eval eval = m_base_evals.back();
-    const int32_t phase = std::max(eval.phase - PHASE_MIN, 0);
-    const int32_t mg_value = eval.mg_eval * phase;
-    const int32_t eg_value = eval.eg_eval * (PHASE_WIDTH - phase);
-
-    // Static features, non-dynamically updated.
-    // TODO: too slow for now, loses a little elo
-    //_eval_static_features(eval);
-
-    int32_t eval_value = (mg_value + eg_value) / PHASE_WIDTH;
-
-    // Get pawn eval
-    uint64_t pawn_key = m_position.get_pawn_key();
-    const PawnTableEntry* entry = m_pawn_hash_table.find(pawn_key);
-    if (entry) {
-        eval_value += entry->eval;
+    const uint64_t key = m_position.get_key();
+    if (const EvalCacheEntry* cached = m_eval_cache.find(key)) {
+        return cached->eval;
     }
-    else {
-        int32_t pawn_eval = _eval_pawns();
-        m_pawn_hash_table.store(pawn_key, pawn_eval);
-        eval_value += pawn_eval;
+
+    if (m_nnue) {
+        const int32_t eval_value = m_nnue->evaluate(m_accumulators[m_base_evals.size() - 1], m_position.get_side_to_move());
+        m_eval_cache.store(key, eval_value);
+        return eval_value;
     }
 
-    return (m_position.get_side_to_move() == Color::White) ? eval_value : -eval_value;
+    // Pawn structure, also used by the static features
+    PawnTableEntry& pawns = _pawn_entry();
+
+    // Material imbalance, phase and endgame scaling
+    const MaterialTableEntry& material = _material_entry();
+    Score eval = m_base_evals.back() + make_score(material.imbalance_mg, material.imbalance_eg);
+
+    // Static features, non-dynamically updated
+    if (m_static_features)
+        _eval_static_features(eval, pawns);
+
+    // Interpolate evaluation based on game phase
+    const Color strong_side = eg_value(eval) > 0 ? Color::White : Color::Black;
+    const int32_t eg_eval = eg_value(eval) * material.scale_factor[+strong_side] / SCALE_FACTOR_NORMAL;
+    const int32_t phase = std::max(material.phase - PHASE_MIN, 0);
+    const int32_t mg_part = mg_value(eval) * phase;
+    const int32_t eg_part = eg_eval * (PHASE_WIDTH - phase);
+
+    int32_t eval_value = (mg_part + eg_part) / PHASE_WIDTH;
+    eval_value += pawns.eval;
+
+    eval_value = (m_position.get_side_to_move() == Color::White) ? eval_value : -eval_value;
+    m_eval_cache.store(key, eval_value);
+    return eval_value;
+}
+
+const EvalCache& SearchPosition::get_eval_cache() const {
+    return m_eval_cache;
+}
+
+void SearchPosition::reset_eval_cache_counters() {
+    m_eval_cache.reset_counters();
 }
 
 int SearchPosition::repetition_count() const {
@@ -59,79 +82,108 @@ int SearchPosition::plies_since_irreversible_move() const {
 }
 
 int32_t SearchPosition::material_phase() const {
-    int32_t material = 0;
-    for (int type = 0; type < 6; ++type) {
-        int32_t count = popcount(m_position.get_pieces(PieceType(type)));
-        material += count * MATERIAL_WEIGHTS[type];
-    }
-    return std::min(material, PHASE_MAX);
+    return _material_entry().phase;
 }
 
-void SearchPosition::make_move(Move move) {
-    m_zobrist_history.push_back(m_position.get_key());
-
-    const Eval& prev_eval = m_base_evals.back();
-    m_base_evals.push_back(prev_eval);
-    Eval& cur_eval = m_base_evals.back();
-
-    MoveType move_type = MoveEncoding::move_type(move);
+void SearchPosition::set_static_features(bool enabled) {
+    m_static_features = enabled;
+    m_eval_cache.clear();
+}
 
-    if (move_type != MoveType::Normal && move_type != MoveType::Castle) {
-        // Slower recomputation for rarer move types
-        m_position.make_move(move);
-        cur_eval = _compute_base_eval();
+void SearchPosition::set_nnue(std::shared_ptr<const NnueNetwork> network) {
+    m_nnue = std::move(network);
+    m_eval_cache.clear();
+    if (!m_nnue) {
+        std::vector<NnueAccumulator>().swap(m_accumulators);
+        return;
     }
-    else {
-        const Color side = m_position.get_side_to_move();
-        const Square from = MoveEncoding::from_sq(move);
-        const Square to = MoveEncoding::to_sq(move);
-        const PieceType piece_type = to_type(m_position.get_piece_at(from));
-        const int32_t sign = (side == Color::White) ? 1 : -1;
-
-        // Move piece
-        cur_eval.mg_eval += sign * (_pst_value(piece_type, side, to, GamePhase::Middlegame)
-                                 - _pst_value(piece_type, side, from, GamePhase::Middlegame));
-        cur_eval.eg_eval += sign * (_pst_value(piece_type, side, to, GamePhase::Endgame)
-                                 - _pst_value(piece_type, side, from, GamePhase::Endgame));
 
-        // Handle capture
-        PieceType captured = m_position.to_capture(move);
-        if (captured != PieceType::None) {
-            cur_eval.phase -= MATERIAL_WEIGHTS[+captured];
+    // Earlier plies are refreshed if they are returned to with undo_move()
+    m_accumulators.resize(std::max<size_t>({m_base_evals.size(), m_base_evals.capacity(), 1}));
+    for (NnueAccumulator& accumulator : m_accumulators)
+        accumulator.valid = false;
+    if (!m_base_evals.empty()) // otherwise refreshed by set_board()
+        m_nnue->refresh(m_accumulators[m_base_evals.size() - 1], m_position);
+}
 
-            cur_eval.mg_eval += sign * _material_value(captured);
-            cur_eval.eg_eval += sign * _material_value(captured);
+// Mixes the bytes of the given values into the hash
+template<typename T>
+static uint64_t hash_values(const T& values, uint64_t hash) {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&values);
+    for (size_t i = 0; i < sizeof(T); ++i)
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    return hash;
+}
 
-            const Color opp = opponent(side);
-            cur_eval.mg_eval += sign * _pst_value(captured, opp, to, GamePhase::Middlegame);
-            cur_eval.eg_eval += sign * _pst_value(captured, opp, to, GamePhase::Endgame);
+uint64_t SearchPosition::eval_fingerprint() const {
+    if (m_nnue)
+        return m_nnue->checksum();
+
+    // Every weight of value_tables.hpp that get_eval() reads, the piece-square tables through PSQT
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = hash_values(MATERIAL_WEIGHTS, hash);
+    hash = hash_values(PIECE_VALUES, hash);
+    hash = hash_values(PSQT, hash);
+    hash = hash_values(BISHOP_PAIR_VALUE, hash);
+    hash = hash_values(KNIGHT_PAIR_VALUE, hash);
+    hash = hash_values(KNIGHT_OUTPOST_VALUE, hash);
+    hash = hash_values(ROOK_FILE_VALUES, hash);
+    hash = hash_values(MOBILITY_VALUES, hash);
+    hash = hash_values(KING_PAWN_SHIELD_VALUES, hash);
+    hash = hash_values(ATTACK_VALUES, hash);
+    hash = hash_values(ATTACK_COUNT_MULTIPLIER, hash);
+    hash = hash_values(DEFENDED_PAWN_VALUE, hash);
+    hash = hash_values(DOUBLED_PAWN_VALUE, hash);
+    hash = hash_values(TRIPLED_PAWN_VALUE, hash);
+    hash = hash_values(BACKWARD_PAWN_VALUE, hash);
+    hash = hash_values(ISOLATED_PAWN_VALUES, hash);
+    hash = hash_values(PASSED_PAWN_VALUES, hash);
+    hash = hash_values(BLOCKED_PASSED_PAWN_VALUE, hash);
+    return hash_values(m_static_features, hash);
+}
 
-            if (captured == PieceType::Bishop && popcount(m_position.get_pieces(opp, PieceType::Bishop)) == 2) {
-                // Adjust for bishop pair
-                cur_eval.mg_eval += sign * BISHOP_PAIR_VALUE[+GamePhase::Middlegame];
-                cur_eval.eg_eval += sign * BISHOP_PAIR_VALUE[+GamePhase::Endgame];
-            }
-            else if (captured == PieceType::Knight && popcount(m_position.get_pieces(opp, PieceType::Knight)) == 2) {
-                // Adjust for knight pair
-                int32_t knight_count = popcount(m_position.get_pieces(opp, PieceType::Knight));
-                cur_eval.mg_eval += sign * KNIGHT_PAIR_VALUE[+GamePhase::Middlegame];
-                cur_eval.eg_eval += sign * KNIGHT_PAIR_VALUE[+GamePhase::Endgame];
-            }
-        }
+void SearchPosition::make_move(Move move) {
+    m_zobrist_history.push_back(m_position.get_key());
 
-        // Handle castling
-        if (move_type == MoveType::Castle) {
-            Square rook_from = to > from ? from + 3 : from - 4;
-            Square rook_to = static_cast<Square>((+to + +from) >> 1); // to + from / 2
+    const Color side = m_position.get_side_to_move();
+    const Square from = MoveEncoding::from_sq(move);
+    const Square to = MoveEncoding::to_sq(move);
+    const MoveType move_type = MoveEncoding::move_type(move);
+    const Piece moved_piece = m_position.get_piece_at(from);
+
+    // Move piece (material and piece-square values in one table lookup per square)
+    const Piece placed_piece = move_type == MoveType::Promotion ? create_piece(side, MoveEncoding::promo(move)) : moved_piece;
+    Score eval = m_base_evals.back() - PSQT[+moved_piece][+from] + PSQT[+placed_piece][+to];
+    NnueFeatureDelta delta;
+    delta.remove(moved_piece, from);
+    delta.add(placed_piece, to);
+
+    // Handle capture (and en passant)
+    const Square capture_square = move_type == MoveType::EnPassant ? to - pawn_dir(side) : to;
+    const Piece captured = m_position.get_piece_at(capture_square);
+    if (captured != Piece::None) {
+        eval -= PSQT[+captured][+capture_square];
+        delta.remove(captured, capture_square);
+    }
 
-            cur_eval.mg_eval += sign * (_pst_value(PieceType::Rook, side, rook_to, GamePhase::Middlegame)
-                                        - _pst_value(PieceType::Rook, side, rook_from, GamePhase::Middlegame));
-            cur_eval.eg_eval += sign * (_pst_value(PieceType::Rook, side, rook_to, GamePhase::Endgame)
-                                        - _pst_value(PieceType::Rook, side, rook_from, GamePhase::Endgame));
-        }
+    // Handle castling
+    if (move_type == MoveType::Castle) {
+        Square rook_from = to > from ? from + 3 : from - 4;
+        Square rook_to = static_cast<Square>((+to + +from) >> 1); // to + from / 2
+        const Piece rook = create_piece(side, PieceType::Rook);
+        eval += PSQT[+rook][+rook_to] - PSQT[+rook][+rook_from];
+        delta.remove(rook, rook_from);
+        delta.add(rook, rook_to);
+    }
 
-        m_position.make_move(move);
+    m_base_evals.push_back(eval);
+    if (m_nnue) {
+        const size_t ply = m_base_evals.size() - 1;
+        if (ply >= m_accumulators.size())
+            m_accumulators.resize(2 * m_accumulators.size());
+        m_nnue->update(m_accumulators[ply - 1], m_accumulators[ply], delta);
     }
+    m_position.make_move(move);
 
     if (m_position.get_halfmove_clock() == 0) {
         // Halfmove clock reset
@@ -145,6 +197,8 @@ bool SearchPosition::undo_move() {
 
     m_base_evals.pop_back();
     m_position.undo_move();
+    if (m_nnue && !m_accumulators[m_base_evals.size() - 1].valid)
+        m_nnue->refresh(m_accumulators[m_base_evals.size() - 1], m_position);
 
     if (m_irreversible_move_plies.back() == m_zobrist_history.size()) {
         m_irreversible_move_plies.pop_back();
@@ -170,51 +224,78 @@ inline int32_t SearchPosition::_material_value(PieceType type) const {
     return PIECE_VALUES[+type];
 }
 
-inline int32_t SearchPosition::_pst_value(PieceType type, Color color, Square square, GamePhase stage) const {
-    const Square idx = square_for_side(square, color);
-    switch (type) {
-        case PieceType::Pawn:   return PST_PAWN[+stage][+idx];
-        case PieceType::Knight: return PST_KNIGHT[+stage][+idx];
-        case PieceType::Bishop: return PST_BISHOP[+stage][+idx];
-        case PieceType::Rook:   return PST_ROOK[+stage][+idx];
-        case PieceType::Queen:  return PST_QUEEN[+stage][+idx];
-        case PieceType::King:   return PST_KING[+stage][+idx];
-        default: return 0;
-    }
-}
-
-inline Eval SearchPosition::_compute_base_eval() {
-    Eval eval = {0, 0, 0};
-    eval.phase = material_phase();
+inline Score SearchPosition::_compute_base_eval() {
+    Score eval = Score::Zero;
 
     for (Square square = Square::A1; square <= Square::H8; ++square) {
         Piece piece = m_position.get_piece_at(square);
         if (piece == Piece::None) continue;
 
-        const PieceType type = to_type(piece);
-        const Color color = to_color(piece);
-        const int32_t sign = (color == Color::White) ? 1 : -1;
+        eval += PSQT[+piece][+square];
+    }
+
+    return eval;
+}
 
-        eval.mg_eval += sign * (_material_value(type) + _pst_value(type, color, square, GamePhase::Middlegame));
-        eval.eg_eval += sign * (_material_value(type) + _pst_value(type, color, square, GamePhase::Endgame));
+inline const MaterialTableEntry& SearchPosition::_material_entry() const {
+    const uint64_t material_key = m_position.get_material_key();
+    const MaterialTableEntry* entry = m_material_hash_table.find(material_key);
+    if (!entry) {
+        entry = m_material_hash_table.store(material_key, _eval_material());
     }
+    return *entry;
+}
+
+inline PawnTableEntry& SearchPosition::_pawn_entry() const {
+    const uint64_t pawn_key = m_position.get_pawn_key();
+    PawnTableEntry* entry = m_pawn_hash_table.find(pawn_key);
+    if (!entry) {
+        entry = m_pawn_hash_table.store(pawn_key, _eval_pawns());
+    }
+    return *entry;
+}
 
-    // Bishop and knight pair bonuses
+MaterialTableEntry SearchPosition::_eval_material() const {
+    MaterialTableEntry entry{};
+
+    int32_t phase = 0;
+    for (int type = 0; type < 6; ++type) {
+        int32_t count = popcount(m_position.get_pieces(PieceType(type)));
+        phase += count * MATERIAL_WEIGHTS[type];
+    }
+    entry.phase = static_cast<int16_t>(std::min(phase, PHASE_MAX));
+
+    int32_t non_pawn_material[2] = {0, 0};
     for (Color color : {Color::White, Color::Black}) {
         const int32_t sign = (color == Color::White) ? 1 : -1;
+
+        // Bishop and knight pair bonuses
         if (popcount(m_position.get_pieces(color, PieceType::Bishop)) >= 2) {
-            eval.mg_eval += sign * BISHOP_PAIR_VALUE[+GamePhase::Middlegame];
-            eval.eg_eval += sign * BISHOP_PAIR_VALUE[+GamePhase::Endgame];
+            entry.imbalance_mg += sign * BISHOP_PAIR_VALUE[+GamePhase::Middlegame];
+            entry.imbalance_eg += sign * BISHOP_PAIR_VALUE[+GamePhase::Endgame];
         }
         if (popcount(m_position.get_pieces(color, PieceType::Knight)) >= 2) {
-            eval.mg_eval += sign * KNIGHT_PAIR_VALUE[+GamePhase::Middlegame];
-            eval.eg_eval += sign * KNIGHT_PAIR_VALUE[+GamePhase::Endgame];
+            entry.imbalance_mg += sign * KNIGHT_PAIR_VALUE[+GamePhase::Middlegame];
+            entry.imbalance_eg += sign * KNIGHT_PAIR_VALUE[+GamePhase::Endgame];
         }
+
+        for (PieceType type : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen})
+            non_pawn_material[+color] += popcount(m_position.get_pieces(color, type)) * _material_value(type);
     }
 
-    return eval;
-}
+    // Without pawns, being at most a minor piece ahead is hard or impossible to win
+    for (Color color : {Color::White, Color::Black}) {
+        const int32_t own = non_pawn_material[+color];
+        const int32_t other = non_pawn_material[+opponent(color)];
+        entry.scale_factor[+color] = SCALE_FACTOR_NORMAL;
+        if (m_position.get_pieces(color, PieceType::Pawn) == 0 && own - other <= _material_value(PieceType::Bishop)) {
+            entry.scale_factor[+color] = own < _material_value(PieceType::Rook) ? 0
+                                       : other <= _material_value(PieceType::Bishop) ? 4 : 14;
+        }
+    }
 
+    return entry;
+}
 
 template<Color color>
 static inline int32_t eval_by_row(Bitboard pieces, const int32_t* value_table) {
@@ -247,18 +328,19 @@ static inline int32_t eval_by_file(Bitboard pieces, const int32_t* value_table)
     return eval;
 }
 
-inline int32_t SearchPosition::_eval_pawns() const {
+inline PawnTableEntry SearchPosition::_eval_pawns() const {
+    const Bitboard w_pawns = m_position.get_pieces(Color::White, PieceType::Pawn);
+    const Bitboard b_pawns = m_position.get_pieces(Color::Black, PieceType::Pawn);
+    PawnTableEntry entry = compute_pawn_sets(w_pawns, b_pawns);
     int32_t eval = 0;
 
     // doubled and tripled pawns
-    const Bitboard w_pawns = m_position.get_pieces(Color::White, PieceType::Pawn);
     const Bitboard w_pawns_behind_own = w_pawns & front_spans<Color::Black>(w_pawns);
     const Bitboard w_pawns_ahead_own = w_pawns & front_spans<Color::White>(w_pawns);
     const Bitboard w_pawns_between_own = w_pawns_behind_own & w_pawns_ahead_own;
     eval += popcount(w_pawns_behind_own) * DOUBLED_PAWN_VALUE;
     eval += popcount(w_pawns_between_own) * TRIPLED_PAWN_VALUE;
 
-    const Bitboard b_pawns = m_position.get_pieces(Color::Black, PieceType::Pawn);
     const Bitboard b_pawns_behind_own = b_pawns & front_spans<Color::White>(b_pawns);
     const Bitboard b_pawns_ahead_own = b_pawns & front_spans<Color::Black>(b_pawns);
     const Bitboard b_pawns_between_own = b_pawns_behind_own & b_pawns_ahead_own;
@@ -277,26 +359,21 @@ inline int32_t SearchPosition::_eval_pawns() const {
     eval -= eval_by_file<Color::Black>(b_isolated_pawns, ISOLATED_PAWN_VALUES);
 
     // passed pawns
-    const Bitboard b_all_front_spans = attack_front_spans<Color::Black>(b_pawns) | front_spans<Color::Black>(b_pawns);
-    const Bitboard w_passed_pawns = w_pawns & ~b_all_front_spans & ~w_pawns_behind_own;
-    eval += eval_by_row<Color::White>(w_passed_pawns, PASSED_PAWN_VALUES);
-
-    const Bitboard w_all_front_spans = attack_front_spans<Color::White>(w_pawns) | front_spans<Color::White>(w_pawns);
-    const Bitboard b_passed_pawns = b_pawns & ~w_all_front_spans & ~b_pawns_behind_own;
-    eval -= eval_by_row<Color::Black>(b_passed_pawns, PASSED_PAWN_VALUES);
+    eval += eval_by_row<Color::White>(entry.passed_pawns[+Color::White], PASSED_PAWN_VALUES);
+    eval -= eval_by_row<Color::Black>(entry.passed_pawns[+Color::Black], PASSED_PAWN_VALUES);
 
     // rammed pawns
     //const Bitboard w_rammed = shift_bb<pawn_dir(Color::Black)>(b_pawns) & w_pawns;
     //const Bitboard b_rammed = shift_bb<pawn_dir(Color::White)>(w_pawns) & b_pawns;
 
     // backward pawns (single pass)
-    const Bitboard b_attacks = pawn_attacks<Color::Black>(b_pawns);
-    const Bitboard b_controlled_stop_squares = b_attacks & ~attack_front_spans<Color::White>(w_pawns);
+    const Bitboard w_attacks = entry.pawn_attacks[+Color::White];
+    const Bitboard b_attacks = entry.pawn_attacks[+Color::Black];
+    const Bitboard b_controlled_stop_squares = b_attacks & ~entry.attack_spans[+Color::White];
     const Bitboard w_backward_pawns = w_pawns & rear_spans<Color::White>(b_controlled_stop_squares);
     eval += popcount(w_backward_pawns) * BACKWARD_PAWN_VALUE;
 
-    const Bitboard w_attacks = pawn_attacks<Color::White>(w_pawns);
-    const Bitboard w_controlled_stop_squares = w_attacks & ~attack_front_spans<Color::Black>(b_pawns);
+    const Bitboard w_controlled_stop_squares = w_attacks & ~entry.attack_spans[+Color::Black];
     const Bitboard b_backward_pawns = b_pawns & rear_spans<Color::Black>(w_controlled_stop_squares);
     eval -= popcount(b_backward_pawns) * BACKWARD_PAWN_VALUE;
 
@@ -307,33 +384,49 @@ inline int32_t SearchPosition::_eval_pawns() const {
     const Bitboard b_defended_pawns = b_pawns & b_attacks;
     eval -= popcount(b_defended_pawns) * DEFENDED_PAWN_VALUE;
 
-    return eval;
+    entry.eval = static_cast<int16_t>(eval);
+    return entry;
 }
 
-void SearchPosition::_eval_static_features(Eval& eval) const {
+void SearchPosition::_eval_static_features(Score& eval, PawnTableEntry& pawns) const {
     // Knight outposts
     constexpr Bitboard CENTRAL_SQUARES = 0x0000001818000000ULL;
     const Bitboard w_knights = m_position.get_pieces(Color::White, PieceType::Knight);
     const Bitboard b_knights = m_position.get_pieces(Color::Black, PieceType::Knight);
-    const Bitboard w_pawn_attacks = pawn_attacks<Color::White>(m_position.get_pieces(Color::White, PieceType::Pawn));
-    const Bitboard b_pawn_attacks = pawn_attacks<Color::Black>(m_position.get_pieces(Color::Black, PieceType::Pawn));
-
-    const Bitboard w_outposts = w_knights & CENTRAL_SQUARES & w_pawn_attacks & ~b_pawn_attacks;
-    const Bitboard b_outposts = b_knights & CENTRAL_SQUARES & b_pawn_attacks & ~w_pawn_attacks;
-    eval.mg_eval += (popcount(w_outposts) - popcount(b_outposts)) * KNIGHT_OUTPOST_VALUE[+GamePhase::Middlegame];
-    eval.eg_eval += (popcount(w_outposts) - popcount(b_outposts)) * KNIGHT_OUTPOST_VALUE[+GamePhase::Endgame];
+    const Bitboard w_pawn_attacks = pawns.pawn_attacks[+Color::White];
+    const Bitboard b_pawn_attacks = pawns.pawn_attacks[+Color::Black];
+
+    // Supported by an own pawn and out of reach of the opponent's pawns, also after they advance
+    const Bitboard w_outposts = w_knights & CENTRAL_SQUARES & w_pawn_attacks & ~pawns.attack_spans[+Color::Black];
+    const Bitboard b_outposts = b_knights & CENTRAL_SQUARES & b_pawn_attacks & ~pawns.attack_spans[+Color::White];
+    eval += (popcount(w_outposts) - popcount(b_outposts)) * make_score(KNIGHT_OUTPOST_VALUE[+GamePhase::Middlegame],
+                                                                       KNIGHT_OUTPOST_VALUE[+GamePhase::Endgame]);
+
+    // Passed pawns blocked by any piece on the stop square
+    const Bitboard occupied = m_position.get_pieces();
+    const int32_t w_blocked_passers = popcount(shift_bb<Shift::Up>(pawns.passed_pawns[+Color::White]) & occupied);
+    const int32_t b_blocked_passers = popcount(shift_bb<Shift::Down>(pawns.passed_pawns[+Color::Black]) & occupied);
+    eval += (w_blocked_passers - b_blocked_passers) * make_score(BLOCKED_PASSED_PAWN_VALUE[+GamePhase::Middlegame],
+                                                                 BLOCKED_PASSED_PAWN_VALUE[+GamePhase::Endgame]);
+
+    // Rooks on semi-open (no own pawns) and open (no pawns) files
+    for (Color side : {Color::White, Color::Black}) {
+        const int32_t sign = (side == Color::White) ? 1 : -1;
+        const uint8_t semi_open_files = pawns.semi_open_files[+side];
+        const uint8_t open_files = semi_open_files & pawns.semi_open_files[+opponent(side)];
+        for (Bitboard rooks = m_position.get_pieces(side, PieceType::Rook); rooks; pop_lsb(rooks)) {
+            const int file = file_of(lsb(rooks));
+            if ((semi_open_files >> file) & 1) {
+                const int open = (open_files >> file) & 1;
+                eval += sign * make_score(ROOK_FILE_VALUES[open][+GamePhase::Middlegame], ROOK_FILE_VALUES[open][+GamePhase::Endgame]);
+            }
+        }
+    }
 
     // Mobility and king safety
     for (Color side : {Color::White, Color::Black}) {
-        const Bitboard all_own_pieces = m_position.get_pieces(side);
         const int32_t sign = (side == Color::White) ? 1 : -1;
-
-        // Pawn shield mask
-        Bitboard shield_squares, king_attacks = MASK_KING_ATTACKS[+lsb(m_position.get_pieces(side, PieceType::King))];
-        if (side == Color::White)
-            shield_squares = shift_bb<Shift::Up>(king_attacks);
-        else
-            shield_squares = shift_bb<Shift::Down>(king_attacks);
+        const Bitboard mobility_area = ~m_position.get_pieces(side);
 
         // Opponent king zone mask
         Square opp_king_square = lsb(m_position.get_pieces(opponent(side), PieceType::King));
@@ -342,86 +435,53 @@ void SearchPosition::_eval_static_features(Eval& eval) const {
             opp_king_zone = opp_king_zone | shift_bb<Shift::DoubleDown>(opp_king_zone);
         else
             opp_king_zone = opp_king_zone | shift_bb<Shift::DoubleUp>(opp_king_zone);
-
-        // Shield pawn count
-        const Bitboard shield_pawns = shield_squares & m_position.get_pieces(side, PieceType::Pawn);
-        const int32_t shield_count = popcount(shield_pawns);
-        eval.mg_eval += sign * shield_count * KING_PAWN_SHIELD_VALUES[+GamePhase::Middlegame];
-        eval.eg_eval += sign * shield_count * KING_PAWN_SHIELD_VALUES[+GamePhase::Endgame];
-
-        // https://www.chessprogramming.org/King_Safety#Attacking_King_Zone
-        int32_t attack_value_mg = 0, attack_value_eg = 0, attack_count = 0;
-
-        // Knights
-        Bitboard knights = m_position.get_pieces(side, PieceType::Knight);
-        while (knights) {
-            Square sq = lsb(knights);
-            Bitboard attacks = MASK_KNIGHT_ATTACKS[+sq] & ~all_own_pieces;
-
-            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
-            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Knight][+GamePhase::Middlegame];
-            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Knight][+GamePhase::Endgame];
-            attack_count += king_zone_attacks & 1;
-
-            int32_t mob = popcount(attacks);
-            eval.mg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Knight][+GamePhase::Middlegame];
-            eval.eg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Knight][+GamePhase::Endgame];
-            pop_lsb(knights);
+        opp_king_zone &= mobility_area;
+
+        // Shield pawn count, cached in the pawn entry for the last seen king square
+        const Square king_square = lsb(m_position.get_pieces(side, PieceType::King));
+        if (pawns.shield_king_square[+side] != king_square) {
+            const Bitboard king_attacks = MASK_KING_ATTACKS[+king_square];
+            const Bitboard shield_squares = (side == Color::White) ? shift_bb<Shift::Up>(king_attacks)
+                                                                   : shift_bb<Shift::Down>(king_attacks);
+            pawns.shield_king_square[+side] = king_square;
+            pawns.shield_count[+side] = static_cast<int8_t>(popcount(shield_squares & m_position.get_pieces(side, PieceType::Pawn)));
         }
+        const int32_t shield_count = pawns.shield_count[+side];
+        Score side_eval = shield_count * make_score(KING_PAWN_SHIELD_VALUES[+GamePhase::Middlegame],
+                                                    KING_PAWN_SHIELD_VALUES[+GamePhase::Endgame]);
 
-        // Bishop
-        Bitboard bishops = m_position.get_pieces(side, PieceType::Bishop);
-        while (bishops) {
-            Square sq = lsb(bishops);
-            Bitboard attacks = attacks_from<PieceType::Bishop>(sq, m_position.get_pieces()) & ~all_own_pieces;
-
-            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
-            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Bishop][+GamePhase::Middlegame];
-            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Bishop][+GamePhase::Endgame];
-            attack_count += king_zone_attacks & 1;
-
-            int32_t mob = popcount(attacks);
-            eval.mg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Bishop][+GamePhase::Middlegame];
-            eval.eg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Bishop][+GamePhase::Endgame];
-            pop_lsb(bishops);
-        }
-
-        // Rook
-        Bitboard rooks = m_position.get_pieces(side, PieceType::Rook);
-        while (rooks) {
-            Square sq = lsb(rooks);
-            Bitboard attacks = attacks_from<PieceType::Rook>(sq, m_position.get_pieces()) & ~all_own_pieces;
-
-            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
-            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Rook][+GamePhase::Middlegame];
-            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Rook][+GamePhase::Endgame];
-            attack_count += king_zone_attacks & 1;
-
-            int32_t mob = popcount(attacks);
-            eval.mg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Rook][+GamePhase::Middlegame];
-            eval.eg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Rook][+GamePhase::Endgame];
-            pop_lsb(rooks);
-        }
-
-        // Queen
-        Bitboard queens = m_position.get_pieces(side, PieceType::Queen);
-        while (queens) {
-            Square sq = lsb(queens);
-            Bitboard attacks = attacks_from<PieceType::Queen>(sq, m_position.get_pieces()) & ~all_own_pieces;
-
-            int32_t king_zone_attacks = popcount(attacks & opp_king_zone);
-            attack_value_mg += king_zone_attacks * ATTACK_VALUES[+PieceType::Queen][+GamePhase::Middlegame];
-            attack_value_eg += king_zone_attacks * ATTACK_VALUES[+PieceType::Queen][+GamePhase::Endgame];
-            attack_count += king_zone_attacks & 1;
-
-            int32_t mob = popcount(attacks);
-            eval.mg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Queen][+GamePhase::Middlegame];
-            eval.eg_eval += sign * mob * MOBILITY_VALUES[+PieceType::Queen][+GamePhase::Endgame];
-            pop_lsb(queens);
-        }
+        // https://www.chessprogramming.org/King_Safety#Attacking_King_Zone
+        Score attack_value = Score::Zero;
+        int32_t attack_count = 0;
+        side_eval += _eval_piece_attacks<PieceType::Knight>(side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+        side_eval += _eval_piece_attacks<PieceType::Bishop>(side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+        side_eval += _eval_piece_attacks<PieceType::Rook>(side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+        side_eval += _eval_piece_attacks<PieceType::Queen>(side, occupied, mobility_area, opp_king_zone, attack_value, attack_count);
+
+        // Attack value scaled by the percentage for the number of attacking pieces
+        const int32_t multiplier = ATTACK_COUNT_MULTIPLIER[std::min(attack_count, 6)];
+        side_eval += make_score(mg_value(attack_value) * multiplier / 100, eg_value(attack_value) * multiplier / 100);
+
+        eval += sign * side_eval;
+    }
+}
 
-        // Final king safety adjustment
-        eval.mg_eval += sign * attack_value_mg * ATTACK_COUNT_MULTIPLIER[attack_count];
-        eval.eg_eval += sign * attack_value_eg * ATTACK_COUNT_MULTIPLIER[attack_count];
+template<PieceType type>
+inline Score SearchPosition::_eval_piece_attacks(Color side, Bitboard occupied, Bitboard mobility_area, Bitboard king_zone,
+                                                 Score& attack_value, int32_t& attack_count) const {
+    int32_t mobility = 0, king_zone_attacks = 0;
+    Bitboard pieces = m_position.get_pieces(side, type);
+    while (pieces) {
+        const Bitboard attacks = attacks_from<type>(lsb(pieces), occupied);
+        const int32_t zone_attacks = popcount(attacks & king_zone);
+        mobility += popcount(attacks & mobility_area);
+        king_zone_attacks += zone_attacks;
+        attack_count += zone_attacks > 0;
+        pop_lsb(pieces);
     }
+
+    attack_value += king_zone_attacks * make_score(ATTACK_VALUES[+type][+GamePhase::Middlegame],
+                                                   ATTACK_VALUES[+type][+GamePhase::Endgame]);
+    return mobility * make_score(MOBILITY_VALUES[+type][+GamePhase::Middlegame],
+                                 MOBILITY_VALUES[+type][+GamePhase::Endgame]);
 }
@@ -0,0 +1,47 @@
+#include "engine/training_data.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+PackedPosition pack_position(const Position& position, int16_t score, uint8_t result) {
+    PackedPosition packed{};
+    packed.occupancy = position.get_pieces();
+    if (popcount(packed.occupancy) > 32)
+        throw std::invalid_argument("pack_position() - more than 32 pieces");
+
+    int count = 0;
+    Bitboard occupancy = packed.occupancy;
+    while (occupancy) {
+        packed.pieces[count >> 1] |= static_cast<uint8_t>(+position.get_piece_at(lsb(occupancy)) << ((count & 1) * 4));
+        ++count;
+        pop_lsb(occupancy);
+    }
+    packed.score = score;
+    packed.result = result;
+    packed.side_to_move = static_cast<uint8_t>(+position.get_side_to_move());
+    return packed;
+}
+
+PackedPosition parse_training_line(const std::string& line) {
+    const size_t first = line.find('|');
+    const size_t second = first == std::string::npos ? std::string::npos : line.find('|', first + 1);
+    if (second == std::string::npos)
+        throw std::invalid_argument("parse_training_line() - expected '<fen> | <score> | <result>': " + line);
+
+    int score;
+    double result;
+    std::istringstream score_stream(line.substr(first + 1, second - first - 1));
+    std::istringstream result_stream(line.substr(second + 1));
+    if (!(score_stream >> score) || !(result_stream >> result))
+        throw std::invalid_argument("parse_training_line() - invalid score or result: " + line);
+
+    uint8_t packed_result;
+    if (result == 1.0) packed_result = RESULT_WHITE_WIN;
+    else if (result == 0.5) packed_result = RESULT_DRAW;
+    else if (result == 0.0) packed_result = RESULT_BLACK_WIN;
+    else throw std::invalid_argument("parse_training_line() - result must be 1.0, 0.5 or 0.0: " + line);
+
+    Position position(line.substr(0, first));
+    score = std::max(-32000, std::min(32000, score));
+    return pack_position(position, static_cast<int16_t>(score), packed_result);
+}
@@ -1,62 +1,237 @@
 #include "engine/transposition_table.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
 #include <limits>
+#include <stdexcept>
+#include "core/bitboard.hpp"
+#include "core/numa.hpp"
+
+// Data word layout:
+// Bits 0-15:  best move
+// Bits 16-31: score
+// Bits 32-39: depth (signed)
+// Bits 40-41: bound
+// Bits 42-47: age
+// Bits 48-63: static eval
+static constexpr uint8_t AGE_MASK = 0x3F;
+
+// A same-key entry of the current search is only overwritten by a non-exact result at most this much shallower.
+// Keeps quiescence stores from wiping deep main search entries.
+static constexpr int16_t SAME_KEY_DEPTH_MARGIN = 3;
+
+static inline uint64_t pack_data(int16_t score, Move best_move, int16_t depth, Bound bound, uint8_t age, int32_t eval) {
+    const int8_t depth8 = static_cast<int8_t>(std::clamp<int16_t>(depth, std::numeric_limits<int8_t>::min(),
+                                                                         std::numeric_limits<int8_t>::max()));
+    const int16_t eval16 = eval == TT_EVAL_NONE ? TT_EVAL_NONE
+        : static_cast<int16_t>(std::clamp<int32_t>(eval, TT_EVAL_NONE + 1, std::numeric_limits<int16_t>::max()));
+    return static_cast<uint64_t>(best_move)
+         | static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16
+         | static_cast<uint64_t>(static_cast<uint8_t>(depth8)) << 32
+         | static_cast<uint64_t>(bound) << 40
+         | static_cast<uint64_t>(age & AGE_MASK) << 42
+         | static_cast<uint64_t>(static_cast<uint16_t>(eval16)) << 48;
+}
+
+static inline int16_t unpack_depth(uint64_t data) { return static_cast<int8_t>(data >> 32); }
+static inline uint8_t unpack_age(uint64_t data) { return static_cast<uint8_t>(data >> 42) & AGE_MASK; }
+static inline Move unpack_move(uint64_t data) { return static_cast<Move>(data); }
+static inline int16_t unpack_eval(uint64_t data) { return static_cast<int16_t>(data >> 48); }
+
+static inline TTEntry unpack(uint64_t key, uint64_t data) {
+    return TTEntry{
+        key,
+        static_cast<int16_t>(data >> 16),
+        unpack_move(data),
+        unpack_depth(data),
+        static_cast<Bound>((data >> 40) & 0x3),
+        unpack_age(data),
+        unpack_eval(data)
+    };
+}
 
 TranspositionTable::TranspositionTable(size_t megabytes) {
     size_t bytes = megabytes * 1024ULL * 1024ULL;
-    size_t n = bytes / sizeof(TTEntry);
+    size_t n = bytes / sizeof(Cluster);
 
     // power of two size
-    size_t pow2 = 16ULL;
+    size_t pow2 = 4ULL;
     while (pow2 * 2 <= n) pow2 *= 2;
-    m_table.resize(pow2);
+    m_table = LargePageArray<Cluster>(pow2);
     m_mask = pow2 - 1;
+
+    // Shared by all search threads, so spread it evenly over the NUMA nodes (before any page is touched)
+    interleave_numa_nodes(m_table.begin(), m_table.size() * sizeof(Cluster));
 }
 
 void TranspositionTable::clear() {
-    for (auto& entry : m_table)
-        entry.key = 0;
+    m_salt = generation_salt(++m_generation);
+    new_search_iteration(); // entries from the previous generation get the lowest replacement priority
 }
 
-const TTEntry* TranspositionTable::find(uint64_t key) const {
-    size_t idx = key & m_mask;
-    for (size_t i = 0; i < m_probe_window; ++i) {
-        if (m_table[idx].key == key) return &m_table[idx];
-        if (m_table[idx].key == 0) return nullptr;
-        idx = (idx + 1) & m_mask;
+void TranspositionTable::wipe(size_t thread_count) {
+    m_table.clear(thread_count);
+    m_generation = 0;
+    m_salt = 0;
+}
+
+std::optional<TTEntry> TranspositionTable::find(uint64_t key) const {
+    const Cluster& cluster = m_table[key & m_mask];
+    const uint64_t salted_key = key ^ m_salt;
+    for (const Slot& slot : cluster.slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t stored_key = slot.key_xor_data.load(std::memory_order_relaxed) ^ data;
+        if (stored_key == salted_key) return unpack(key, data);
+        if (stored_key == 0) return std::nullopt; // slots are filled in order, rest are empty
     }
-    return nullptr;
+    return std::nullopt;
 }
 
-void TranspositionTable::store(uint64_t key, int32_t score, int16_t depth,
-                                Bound bound, Move best_move) {
-    size_t idx = key & m_mask;
-    size_t replace_idx = idx;
+void TranspositionTable::store(uint64_t key, int16_t score, int16_t depth,
+                                Bound bound, Move best_move, int32_t eval) {
+    Cluster& cluster = m_table[key & m_mask];
+    const uint64_t salted_key = key ^ m_salt;
+    Slot* replace = &cluster.slots[0];
 
     int best_keep_score = std::numeric_limits<int>::max();
-    for (size_t i = 0; i < m_probe_window; ++i) {
-        TTEntry &entry = m_table[idx];
-        if (entry.key == 0) { replace_idx = idx; break; } // empty slot: free to use
-        if (entry.key == key) { replace_idx = idx; break; } // same key: overwrite
+    for (Slot& slot : cluster.slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        const uint64_t stored_key = slot.key_xor_data.load(std::memory_order_relaxed) ^ data;
+        if (stored_key == 0) { replace = &slot; break; } // empty slot: free to use
+        if (stored_key == salted_key) {
+            // same key: overwrite unless it is a deeper entry of this search, keeping what the new store lacks
+            if (bound != Bound::Exact && depth + SAME_KEY_DEPTH_MARGIN < unpack_depth(data) && unpack_age(data) == m_age)
+                return;
+            if (best_move == NO_MOVE)
+                best_move = unpack_move(data);
+            if (eval == TT_EVAL_NONE)
+                eval = unpack_eval(data);
+            replace = &slot;
+            break;
+        }
 
         // prefer entries with same age and deeper depth
-        int keep_score = entry.depth + ((entry.age == m_age) ? 100000 : 0);
+        int keep_score = unpack_depth(data) + ((unpack_age(data) == m_age) ? 100000 : 0);
 
         // replace the entry with the smallest keep_score
         if (keep_score < best_keep_score) {
             best_keep_score = keep_score;
-            replace_idx = idx;
+            replace = &slot;
         }
+    }
+
+    const uint64_t data = pack_data(score, best_move, depth, bound, m_age, eval);
+    replace->key_xor_data.store(salted_key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::new_search_iteration() { m_age = (m_age + 1) & AGE_MASK; }
 
-        idx = (idx + 1) & m_mask;
+// Saved table file layout (native byte order):
+// Bytes 0-4095: FileHeader, zero padded
+// Bytes 4096-:  clusters, as in memory (page aligned so that they can be mapped directly)
+static constexpr char FILE_MAGIC[8] = {'C', 'B', 'O', 'T', 'T', 'T', 'B', 'L'};
+static constexpr uint32_t FILE_VERSION = 3;
+static constexpr size_t FILE_DATA_OFFSET = 4096;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t cluster_bytes;
+    uint64_t cluster_count;
+    uint64_t zobrist_fingerprint;
+    uint64_t eval_fingerprint; // static evals of the entries are only valid under the same evaluation
+    uint64_t generation;
+    uint64_t data_checksum;
+    uint8_t age;
+    uint8_t padding[7];
+    uint64_t header_checksum; // of all fields above
+};
+static_assert(sizeof(FileHeader) <= FILE_DATA_OFFSET);
+
+static uint64_t checksum(const void* ptr, size_t bytes, uint64_t hash = 0) {
+    const uint8_t* data = static_cast<const uint8_t*>(ptr);
+    for (size_t i = 0; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ULL + (hash >> 29);
     }
+    for (size_t i = bytes & ~size_t(7); i < bytes; ++i)
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+// Tables saved by a build with different Zobrist keys would never produce hits (or worse, wrong ones)
+static uint64_t zobrist_fingerprint() {
+    uint64_t hash = checksum(ZOBRIST_PIECE, sizeof(ZOBRIST_PIECE));
+    hash = checksum(ZOBRIST_CASTLING, sizeof(ZOBRIST_CASTLING), hash);
+    hash = checksum(ZOBRIST_EP, sizeof(ZOBRIST_EP), hash);
+    return checksum(&ZOBRIST_SIDE, sizeof(ZOBRIST_SIDE), hash);
+}
+
+void TranspositionTable::save(const std::string& path, uint64_t eval_fingerprint) const {
+    const size_t data_bytes = m_table.size() * sizeof(Cluster);
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.cluster_bytes = sizeof(Cluster);
+    header.cluster_count = m_table.size();
+    header.zobrist_fingerprint = zobrist_fingerprint();
+    header.eval_fingerprint = eval_fingerprint;
+    header.generation = m_generation;
+    header.data_checksum = checksum(m_table.begin(), data_bytes);
+    header.age = m_age;
+    header.header_checksum = checksum(&header, offsetof(FileHeader, header_checksum));
 
-    auto &dst = m_table[replace_idx];
-    dst.key = key;
-    dst.score = score;
-    dst.depth = depth;
-    dst.bound = bound;
-    dst.best_move = best_move;
-    dst.age = m_age;
+    char header_block[FILE_DATA_OFFSET] = {};
+    std::memcpy(header_block, &header, sizeof(header));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("TranspositionTable::save() - cannot open file: " + path);
+    file.write(header_block, sizeof(header_block));
+    file.write(reinterpret_cast<const char*>(m_table.begin()), static_cast<std::streamsize>(data_bytes));
+    if (!file.flush())
+        throw std::runtime_error("TranspositionTable::save() - failed to write file: " + path);
 }
 
-void TranspositionTable::new_search_iteration() { m_age += 1; }
+void TranspositionTable::load(const std::string& path, bool verify_checksum, uint64_t eval_fingerprint) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw std::runtime_error("TranspositionTable::load() - cannot open file: " + path);
+    const size_t file_bytes = static_cast<size_t>(file.tellg());
+
+    FileHeader header{};
+    file.seekg(0);
+    if (file_bytes < FILE_DATA_OFFSET || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("TranspositionTable::load() - file too short: " + path);
+    file.close();
+
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        throw std::runtime_error("TranspositionTable::load() - not a transposition table file: " + path);
+    if (header.header_checksum != checksum(&header, offsetof(FileHeader, header_checksum)))
+        throw std::runtime_error("TranspositionTable::load() - header checksum mismatch: " + path);
+    if (header.version != FILE_VERSION || header.cluster_bytes != sizeof(Cluster))
+        throw std::runtime_error("TranspositionTable::load() - unsupported file version: " + path);
+    if (header.zobrist_fingerprint != zobrist_fingerprint())
+        throw std::runtime_error("TranspositionTable::load() - file was saved with different Zobrist keys: " + path);
+    if (header.eval_fingerprint != eval_fingerprint)
+        throw std::runtime_error("TranspositionTable::load() - file was saved with a different evaluation: " + path);
+
+    const size_t cluster_count = header.cluster_count;
+    if (cluster_count < 4 || (cluster_count & (cluster_count - 1)) != 0
+        || file_bytes - FILE_DATA_OFFSET != cluster_count * sizeof(Cluster))
+        throw std::runtime_error("TranspositionTable::load() - invalid table size: " + path);
+
+    LargePageArray<Cluster> table = LargePageArray<Cluster>::map_file(path, FILE_DATA_OFFSET, cluster_count);
+    if (verify_checksum && header.data_checksum != checksum(table.begin(), cluster_count * sizeof(Cluster)))
+        throw std::runtime_error("TranspositionTable::load() - data checksum mismatch: " + path);
+
+    m_table = std::move(table);
+    m_mask = cluster_count - 1;
+    m_generation = header.generation;
+    m_salt = generation_salt(m_generation);
+    m_age = header.age & AGE_MASK;
+}
@@ -0,0 +1,316 @@
+#include "trainer/nnue_trainer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+// Weights are clipped so that the quantized accumulators and output sums cannot overflow
+static constexpr float WEIGHT_CLIP = 1.98f;
+
+static constexpr float ADAM_BETA1 = 0.9f;
+static constexpr float ADAM_BETA2 = 0.999f;
+static constexpr float ADAM_EPSILON = 1e-8f;
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+static inline void add_row(float* dst, const float* src) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+}
+
+// Sum of clipped ReLU activations times output weights
+static inline float output_sum(const float* hidden, const float* weights) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 sum = zero;
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(hidden + i), zero), one);
+        sum = _mm256_fmadd_ps(a, _mm256_loadu_ps(weights + i), sum);
+    }
+    __m128 sum128 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    sum128 = _mm_add_ps(sum128, _mm_movehl_ps(sum128, sum128));
+    sum128 = _mm_add_ss(sum128, _mm_shuffle_ps(sum128, sum128, 1));
+    return _mm_cvtss_f32(sum128);
+}
+
+// Output weight gradient and hidden layer gradient (through the clipped ReLU) for output gradient g
+static inline void backward_hidden(const float* hidden, const float* weights, float g,
+                                   float* weight_gradient, float* hidden_gradient) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 gv = _mm256_set1_ps(g);
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        const __m256 h = _mm256_loadu_ps(hidden + i);
+        const __m256 a = _mm256_min_ps(_mm256_max_ps(h, zero), one);
+        _mm256_storeu_ps(weight_gradient + i, _mm256_fmadd_ps(gv, a, _mm256_loadu_ps(weight_gradient + i)));
+        const __m256 active = _mm256_and_ps(_mm256_cmp_ps(h, zero, _CMP_GT_OQ), _mm256_cmp_ps(h, one, _CMP_LT_OQ));
+        _mm256_storeu_ps(hidden_gradient + i, _mm256_and_ps(active, _mm256_mul_ps(gv, _mm256_loadu_ps(weights + i))));
+    }
+}
+
+#else
+
+static inline void add_row(float* dst, const float* src) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+        dst[i] += src[i];
+}
+
+static inline float output_sum(const float* hidden, const float* weights) {
+    float sum = 0.0f;
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+        sum += std::clamp(hidden[i], 0.0f, 1.0f) * weights[i];
+    return sum;
+}
+
+static inline void backward_hidden(const float* hidden, const float* weights, float g,
+                                   float* weight_gradient, float* hidden_gradient) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        weight_gradient[i] += g * std::clamp(hidden[i], 0.0f, 1.0f);
+        hidden_gradient[i] = (hidden[i] > 0.0f && hidden[i] < 1.0f) ? g * weights[i] : 0.0f;
+    }
+}
+
+#endif
+
+static inline float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+NnueTrainer::NnueTrainer(const NnueTrainerConfig& config)
+  : m_config(config),
+    m_learning_rate(config.learning_rate),
+    m_parameters(PARAMETER_COUNT, 0.0f),
+    m_moment1(PARAMETER_COUNT, 0.0f),
+    m_moment2(PARAMETER_COUNT, 0.0f),
+    m_thread_gradients(std::max(1, config.threads), std::vector<float>(PARAMETER_COUNT))
+{
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<float> feature_dist(-0.1f, 0.1f);
+    std::uniform_real_distribution<float> output_dist(-0.05f, 0.05f);
+    for (size_t i = FEATURE_WEIGHTS; i < FEATURE_BIASES; ++i)
+        m_parameters[i] = feature_dist(rng);
+    for (size_t i = OUTPUT_WEIGHTS; i < OUTPUT_BIAS; ++i)
+        m_parameters[i] = output_dist(rng);
+}
+
+void NnueTrainer::_forward_hidden(const PackedPosition& position, float (*hidden)[NNUE_HIDDEN],
+                                  int (*features)[32], int* feature_counts) const {
+    const Color stm = static_cast<Color>(position.side_to_move);
+    for (int side = 0; side < 2; ++side) {
+        feature_counts[side] = packed_features(position, side == 0 ? stm : opponent(stm), features[side]);
+        std::memcpy(hidden[side], &m_parameters[FEATURE_BIASES], sizeof(hidden[side]));
+        for (int j = 0; j < feature_counts[side]; ++j)
+            add_row(hidden[side], &m_parameters[FEATURE_WEIGHTS + size_t(features[side][j]) * NNUE_HIDDEN]);
+    }
+}
+
+float NnueTrainer::evaluate(const PackedPosition& position) const {
+    float hidden[2][NNUE_HIDDEN];
+    int features[2][32], feature_counts[2];
+    _forward_hidden(position, hidden, features, feature_counts);
+    const float output = output_sum(hidden[0], &m_parameters[OUTPUT_WEIGHTS])
+                       + output_sum(hidden[1], &m_parameters[OUTPUT_WEIGHTS + NNUE_HIDDEN])
+                       + m_parameters[OUTPUT_BIAS];
+    return output * NNUE_EVAL_SCALE;
+}
+
+double NnueTrainer::_accumulate_gradient(const PackedPosition* positions, size_t count, float* gradient) const {
+    double loss = 0.0;
+    float hidden[2][NNUE_HIDDEN], hidden_gradient[NNUE_HIDDEN];
+    int features[2][32], feature_counts[2];
+
+    for (size_t n = 0; n < count; ++n) {
+        const PackedPosition& position = positions[n];
+        _forward_hidden(position, hidden, features, feature_counts);
+        const float output = output_sum(hidden[0], &m_parameters[OUTPUT_WEIGHTS])
+                           + output_sum(hidden[1], &m_parameters[OUTPUT_WEIGHTS + NNUE_HIDDEN])
+                           + m_parameters[OUTPUT_BIAS];
+
+        // Target and prediction as win probabilities for the side to move
+        const bool white = static_cast<Color>(position.side_to_move) == Color::White;
+        const float score = white ? position.score : -position.score;
+        const float result = (white ? position.result : 2 - position.result) * 0.5f;
+        const float target = m_config.lambda * sigmoid(score / NNUE_EVAL_SCALE) + (1.0f - m_config.lambda) * result;
+        const float prediction = sigmoid(output);
+        const float error = prediction - target;
+        loss += error * error;
+
+        // Back propagate d(error^2)/d(output)
+        const float g = 2.0f * error * prediction * (1.0f - prediction);
+        gradient[OUTPUT_BIAS] += g;
+        for (int side = 0; side < 2; ++side) {
+            backward_hidden(hidden[side], &m_parameters[OUTPUT_WEIGHTS + side * NNUE_HIDDEN], g,
+                            &gradient[OUTPUT_WEIGHTS + side * NNUE_HIDDEN], hidden_gradient);
+            add_row(&gradient[FEATURE_BIASES], hidden_gradient);
+            for (int j = 0; j < feature_counts[side]; ++j)
+                add_row(&gradient[FEATURE_WEIGHTS + size_t(features[side][j]) * NNUE_HIDDEN], hidden_gradient);
+        }
+    }
+    return loss;
+}
+
+void NnueTrainer::_adam_step(size_t begin, size_t end, size_t gradient_count, float gradient_scale) {
+    const float correction1 = 1.0f - std::pow(ADAM_BETA1, static_cast<float>(m_step));
+    const float correction2 = 1.0f - std::pow(ADAM_BETA2, static_cast<float>(m_step));
+    const float step_size = m_learning_rate * std::sqrt(correction2) / correction1;
+
+    for (size_t i = begin; i < end; ++i) {
+        float g = 0.0f;
+        for (size_t t = 0; t < gradient_count; ++t)
+            g += m_thread_gradients[t][i];
+        g *= gradient_scale;
+
+        m_moment1[i] = ADAM_BETA1 * m_moment1[i] + (1.0f - ADAM_BETA1) * g;
+        m_moment2[i] = ADAM_BETA2 * m_moment2[i] + (1.0f - ADAM_BETA2) * g * g;
+        float value = m_parameters[i] - step_size * m_moment1[i] / (std::sqrt(m_moment2[i]) + ADAM_EPSILON);
+        if (i != OUTPUT_BIAS)
+            value = std::clamp(value, -WEIGHT_CLIP, WEIGHT_CLIP);
+        m_parameters[i] = value;
+    }
+}
+
+double NnueTrainer::train_batch(const PackedPosition* positions, size_t count) {
+    if (count == 0) return 0.0;
+
+    // Data parallel gradients, at least a few hundred positions per thread
+    const size_t thread_count = std::clamp<size_t>(count / 256, 1, m_thread_gradients.size());
+    const size_t per_thread = (count + thread_count - 1) / thread_count;
+    std::vector<double> losses(thread_count, 0.0);
+    auto accumulate = [&](size_t t) {
+        std::fill(m_thread_gradients[t].begin(), m_thread_gradients[t].end(), 0.0f);
+        const size_t begin = std::min(count, t * per_thread);
+        const size_t end = std::min(count, begin + per_thread);
+        losses[t] = _accumulate_gradient(positions + begin, end - begin, m_thread_gradients[t].data());
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < thread_count; ++t)
+        workers.emplace_back(accumulate, t);
+    accumulate(0);
+    for (std::thread& worker : workers)
+        worker.join();
+    workers.clear();
+
+    // Sum the gradients and update the parameters, split by parameter ranges
+    ++m_step;
+    const float gradient_scale = 1.0f / static_cast<float>(count);
+    const size_t per_range = (PARAMETER_COUNT + thread_count - 1) / thread_count;
+    auto update = [&](size_t t) {
+        const size_t begin = std::min(PARAMETER_COUNT, t * per_range);
+        _adam_step(begin, std::min(PARAMETER_COUNT, begin + per_range), thread_count, gradient_scale);
+    };
+    for (size_t t = 1; t < thread_count; ++t)
+        workers.emplace_back(update, t);
+    update(0);
+    for (std::thread& worker : workers)
+        worker.join();
+
+    double loss = 0.0;
+    for (double l : losses) loss += l;
+    return loss / static_cast<double>(count);
+}
+
+std::unique_ptr<NnueNetwork> NnueTrainer::quantize() const {
+    auto quantize_value = [](float value, int32_t scale) {
+        return static_cast<int16_t>(std::lround(value * static_cast<float>(scale)));
+    };
+
+    auto network = std::make_unique<NnueNetwork>();
+    for (int feature = 0; feature < NNUE_INPUTS; ++feature)
+        for (int i = 0; i < NNUE_HIDDEN; ++i)
+            network->feature_weights[feature][i] = quantize_value(m_parameters[FEATURE_WEIGHTS + size_t(feature) * NNUE_HIDDEN + i], NNUE_QA);
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+        network->feature_biases[i] = quantize_value(m_parameters[FEATURE_BIASES + i], NNUE_QA);
+    for (int side = 0; side < 2; ++side)
+        for (int i = 0; i < NNUE_HIDDEN; ++i)
+            network->output_weights[side][i] = quantize_value(m_parameters[OUTPUT_WEIGHTS + side * NNUE_HIDDEN + i], NNUE_QB);
+    network->output_bias = static_cast<int32_t>(std::lround(m_parameters[OUTPUT_BIAS] * NNUE_QA * NNUE_QB));
+    return network;
+}
+
+/**
+ * Reads a training file in chunks of several minibatches and shuffles each chunk.
+ */
+class PositionStream {
+public:
+    PositionStream(const std::string& path, size_t chunk_size, uint64_t seed)
+      : m_file(path, std::ios::binary), m_path(path), m_chunk_size(chunk_size), m_rng(seed)
+    {
+        if (!m_file)
+            throw std::runtime_error("NnueTrainer::train() - cannot open data file: " + path);
+        m_file.seekg(0, std::ios::end);
+        const std::streamoff bytes = m_file.tellg();
+        if (bytes <= 0 || bytes % sizeof(PackedPosition) != 0)
+            throw std::runtime_error("NnueTrainer::train() - data file size is not a multiple of the record size: " + path);
+        m_position_count = static_cast<size_t>(bytes) / sizeof(PackedPosition);
+    }
+
+    size_t position_count() const { return m_position_count; }
+
+    void rewind() {
+        m_file.clear();
+        m_file.seekg(0);
+    }
+
+    // Read the next chunk, an empty chunk marks the end of the file
+    std::vector<PackedPosition> next_chunk() {
+        std::vector<PackedPosition> chunk(m_chunk_size);
+        m_file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(m_chunk_size * sizeof(PackedPosition)));
+        if (m_file.bad())
+            throw std::runtime_error("NnueTrainer::train() - failed to read data file: " + m_path);
+        chunk.resize(static_cast<size_t>(m_file.gcount()) / sizeof(PackedPosition));
+        std::shuffle(chunk.begin(), chunk.end(), m_rng);
+        return chunk;
+    }
+
+private:
+    std::ifstream m_file;
+    std::string m_path;
+    size_t m_chunk_size;
+    size_t m_position_count;
+    std::mt19937_64 m_rng;
+};
+
+void NnueTrainer::train(const std::string& data_path, const std::string& output_path) {
+    PositionStream stream(data_path, m_config.batch_size * m_config.shuffle_batches, m_config.seed);
+    std::cout << "Training on " << stream.position_count() << " positions with " << m_thread_gradients.size()
+              << " threads" << std::endl;
+
+    for (int epoch = 1; epoch <= m_config.epochs; ++epoch) {
+        const auto start = std::chrono::steady_clock::now();
+        double loss_sum = 0.0;
+        size_t batches = 0;
+
+        // Read the next chunk from disk while training on the current one
+        stream.rewind();
+        std::future<std::vector<PackedPosition>> pending = std::async(std::launch::async, [&] { return stream.next_chunk(); });
+        while (true) {
+            std::vector<PackedPosition> chunk = pending.get();
+            if (chunk.empty()) break;
+            pending = std::async(std::launch::async, [&] { return stream.next_chunk(); });
+
+            for (size_t offset = 0; offset < chunk.size(); offset += m_config.batch_size) {
+                loss_sum += train_batch(chunk.data() + offset, std::min(m_config.batch_size, chunk.size() - offset));
+                ++batches;
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "epoch " << epoch << " loss " << loss_sum / static_cast<double>(std::max<size_t>(batches, 1))
+                  << " lr " << m_learning_rate << " positions/s "
+                  << static_cast<uint64_t>(static_cast<double>(stream.position_count()) / seconds) << std::endl;
+
+        quantize()->save(output_path);
+        m_learning_rate *= m_config.learning_rate_decay;
+    }
+}
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "trainer/spsa_tuner.hpp"
+
+static void print_usage() {
+    std::cout << "Usage:\n"
+              << "  spsa <openings.epd> <output.txt> [--iterations N] [--pairs N] [--nodes N] [--threads N]\n"
+              << "       [--lr X] [--max-plies N] [--seed N] [--params PATH]\n"
+              << "      Tune the search parameters with SPSA over fixed-node self-play games between perturbed parameter sets.\n"
+              << "      The parameters are written to the output as \"name value\" lines after every iteration.\n"
+              << "      --params continues from a file in the same format.\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (argc - 3) % 2 != 0) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        SpsaConfig config;
+        config.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        SearchParameters start;
+
+        for (int i = 3; i + 1 < argc; i += 2) {
+            const std::string option = argv[i];
+            const std::string value = argv[i + 1];
+            if (option == "--iterations") config.iterations = std::stoi(value);
+            else if (option == "--pairs") config.game_pairs = std::stoi(value);
+            else if (option == "--nodes") config.nodes_per_move = std::stoll(value);
+            else if (option == "--threads") config.threads = std::stoi(value);
+            else if (option == "--lr") config.learning_rate = std::stod(value);
+            else if (option == "--max-plies") config.max_plies = std::stoi(value);
+            else if (option == "--seed") config.seed = std::stoull(value);
+            else if (option == "--params") start = SearchParameters::load(value);
+            else throw std::invalid_argument("unknown option: " + option);
+        }
+
+        SpsaTuner tuner(config, start);
+        const size_t loaded = tuner.load_openings(argv[1]);
+        std::cout << "Loaded " << loaded << " openings, playing " << 2 * config.game_pairs << " games per iteration on "
+                  << config.threads << " threads" << std::endl;
+
+        SpsaResult total;
+        for (int iteration = 1; iteration <= config.iterations; ++iteration) {
+            const auto start_time = std::chrono::steady_clock::now();
+            const SpsaResult result = tuner.step();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            total.wins += result.wins;
+            total.draws += result.draws;
+            total.losses += result.losses;
+
+            std::cout << "iteration " << iteration << " +" << result.wins << " =" << result.draws << " -" << result.losses
+                      << " (" << seconds << " s, total draws " << total.draws << "/" << total.wins + total.draws + total.losses << ")\n";
+            const auto& table = SearchParameters::table();
+            for (size_t i = 0; i < table.size(); ++i)
+                std::cout << "  " << table[i].name << " " << tuner.values()[i] << "\n";
+            std::cout << std::flush;
+
+            std::ofstream output(argv[2], std::ios::trunc);
+            output << tuner.parameters().to_string();
+            if (!output.flush())
+                throw std::runtime_error("failed to write output file: " + std::string(argv[2]));
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
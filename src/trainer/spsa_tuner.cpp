@@ -0,0 +1,219 @@
+#include "trainer/spsa_tuner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include "core/move_generation.hpp"
+
+// Score at which both engines agreeing ends the game, and for how many plies they must agree
+static constexpr int32_t ADJUDICATION_SCORE = 1000;
+static constexpr int ADJUDICATION_PLIES = 4;
+
+std::vector<FEN> load_openings(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("load_openings() - cannot open file: " + path);
+
+    std::vector<FEN> openings;
+    Position position;
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find(';'));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty())
+            continue;
+        position.from_fen(line); // throws on an invalid position
+        openings.push_back(line);
+    }
+    if (openings.empty())
+        throw std::runtime_error("load_openings() - no positions in file: " + path);
+    return openings;
+}
+
+// No side can deliver checkmate with only a king and at most one minor piece on the board
+static bool insufficient_material(const Position& position) {
+    const Bitboard heavy = position.get_pieces(PieceType::Pawn)
+                         | position.get_pieces(PieceType::Rook)
+                         | position.get_pieces(PieceType::Queen);
+    const Bitboard minors = position.get_pieces(PieceType::Knight) | position.get_pieces(PieceType::Bishop);
+    return heavy == 0ULL && popcount(minors) <= 1;
+}
+
+double play_game(MinimaxAI& white, MinimaxAI& black, const FEN& opening, int max_plies) {
+    Position position(opening);
+    std::vector<uint64_t> keys = {position.get_key()};
+    white.set_board(opening);
+    black.set_board(opening);
+    white.clear_transposition_table();
+    black.clear_transposition_table();
+
+    MoveList move_list;
+    int adjudication_sign = 0;
+    int adjudication_plies = 0;
+    for (int ply = 0; ply < max_plies; ++ply) {
+        const Color side = position.get_side_to_move();
+        move_list.generate<GenerateType::Legal>(position);
+        if (move_list.count() == 0) {
+            if (!position.in_check())
+                return 0.5; // stalemate
+            return side == Color::White ? 0.0 : 1.0;
+        }
+        if (position.get_halfmove_clock() >= 100 || insufficient_material(position))
+            return 0.5;
+
+        // Threefold repetition, only positions since the last irreversible move with the same side to move can repeat
+        int repetitions = 0;
+        const size_t last = keys.size() - 1;
+        const size_t reversible = std::min<size_t>(position.get_halfmove_clock(), last);
+        for (size_t back = 0; back <= reversible; back += 2)
+            repetitions += keys[last - back] == keys[last];
+        if (repetitions >= 3)
+            return 0.5;
+
+        MinimaxAI& engine = side == Color::White ? white : black;
+        const UCI move = engine.compute_move();
+
+        // Both engines must see a decisive score for the same side for several plies
+        const int32_t score = side == Color::White ? engine.get_stats().eval : -engine.get_stats().eval;
+        const int sign = score >= ADJUDICATION_SCORE ? 1 : score <= -ADJUDICATION_SCORE ? -1 : 0;
+        adjudication_plies = (sign != 0 && sign == adjudication_sign) ? adjudication_plies + 1 : 1;
+        adjudication_sign = sign;
+        if (sign != 0 && adjudication_plies >= ADJUDICATION_PLIES)
+            return sign > 0 ? 1.0 : 0.0;
+
+        position.make_move(position.move_from_uci(move));
+        keys.push_back(position.get_key());
+        white.apply_move(move);
+        black.apply_move(move);
+    }
+    return 0.5;
+}
+
+SpsaTuner::SpsaTuner(const SpsaConfig& config, const SearchParameters& start)
+  : m_config(config),
+    m_rng(config.seed)
+{
+    for (const SearchParameters::Info& info : SearchParameters::table())
+        m_values.push_back(static_cast<double>(start.*info.member));
+}
+
+SpsaTuner::~SpsaTuner() = default;
+
+size_t SpsaTuner::load_openings(const std::string& path) {
+    m_openings = ::load_openings(path);
+    return m_openings.size();
+}
+
+void SpsaTuner::set_openings(std::vector<FEN> openings) {
+    m_openings = std::move(openings);
+}
+
+SpsaResult SpsaTuner::step() {
+    if (m_openings.empty())
+        throw std::runtime_error("SpsaTuner::step() - no openings!");
+
+    const auto& table = SearchParameters::table();
+    const int k = ++m_iteration;
+
+    // Gain schedules, scaled so that c_k = step and a_k = learning_rate * step^2 at the last planned iteration
+    const double n = static_cast<double>(std::max(m_config.iterations, k));
+    const double stability = m_config.stability >= 0.0 ? m_config.stability : 0.1 * n;
+    const double c_scale = std::pow(n / k, m_config.gamma);
+    const double a_scale = std::pow((stability + n) / (stability + k), m_config.alpha);
+
+    // Random +-1 perturbation of every parameter
+    std::vector<double> plus = m_values, minus = m_values, delta(m_values.size());
+    std::uniform_int_distribution<int> coin(0, 1);
+    for (size_t i = 0; i < table.size(); ++i) {
+        delta[i] = coin(m_rng) ? 1.0 : -1.0;
+        plus[i] += table[i].step * c_scale * delta[i];
+        minus[i] -= table[i].step * c_scale * delta[i];
+    }
+    const SearchParameters plus_params = _to_parameters(plus);
+    const SearchParameters minus_params = _to_parameters(minus);
+
+    std::vector<FEN> openings(static_cast<size_t>(m_config.game_pairs));
+    std::uniform_int_distribution<size_t> pick(0, m_openings.size() - 1);
+    for (FEN& opening : openings)
+        opening = m_openings[pick(m_rng)];
+
+    // Games are taken from a shared counter, as their lengths vary a lot.
+    // Game 2i has the plus parameters as white, game 2i+1 as black.
+    const size_t game_count = 2 * openings.size();
+    const size_t thread_count = std::clamp<size_t>(game_count, 1, std::max(1, m_config.threads));
+    while (m_engines.size() < 2 * thread_count) {
+        m_engines.emplace_back(new MinimaxAI(99, 1e6, m_config.tt_size_megabytes, false));
+        m_engines.back()->set_max_nodes(m_config.nodes_per_move);
+    }
+
+    std::vector<double> scores(game_count); // plus parameters' perspective
+    std::atomic<size_t> next_game = 0;
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&, t] {
+            try {
+                MinimaxAI& plus_engine = *m_engines[2 * t];
+                MinimaxAI& minus_engine = *m_engines[2 * t + 1];
+                plus_engine.set_search_parameters(plus_params);
+                minus_engine.set_search_parameters(minus_params);
+                for (size_t game = next_game++; game < game_count; game = next_game++) {
+                    const FEN& opening = openings[game / 2];
+                    if (game % 2 == 0)
+                        scores[game] = play_game(plus_engine, minus_engine, opening, m_config.max_plies);
+                    else
+                        scores[game] = 1.0 - play_game(minus_engine, plus_engine, opening, m_config.max_plies);
+                }
+            }
+            catch (...) {
+                errors[t] = std::current_exception();
+                next_game = game_count;
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    for (const std::exception_ptr& error : errors)
+        if (error) std::rethrow_exception(error);
+
+    SpsaResult result;
+    for (double score : scores) {
+        if (score == 1.0) ++result.wins;
+        else if (score == 0.0) ++result.losses;
+        else ++result.draws;
+    }
+
+    // Gradient step. With c_k = step * c_scale and a_k = learning_rate * step^2 * a_scale,
+    // theta += a_k * (wins - losses) / (c_k * delta).
+    const double match = static_cast<double>(result.wins - result.losses);
+    for (size_t i = 0; i < table.size(); ++i) {
+        const double gain = m_config.learning_rate * table[i].step * a_scale / c_scale;
+        m_values[i] = std::clamp(m_values[i] + gain * match * delta[i],
+                                 static_cast<double>(table[i].min), static_cast<double>(table[i].max));
+    }
+    return result;
+}
+
+int SpsaTuner::iteration() const {
+    return m_iteration;
+}
+
+SearchParameters SpsaTuner::parameters() const {
+    return _to_parameters(m_values);
+}
+
+const std::vector<double>& SpsaTuner::values() const {
+    return m_values;
+}
+
+SearchParameters SpsaTuner::_to_parameters(const std::vector<double>& values) const {
+    SearchParameters params;
+    const auto& table = SearchParameters::table();
+    for (size_t i = 0; i < table.size(); ++i)
+        params.*table[i].member = std::clamp(static_cast<int32_t>(std::lround(values[i])), table[i].min, table[i].max);
+    return params;
+}
@@ -0,0 +1,593 @@
+#include "trainer/texel_tuner.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "core/move_generation.hpp"
+#include "engine/material_hash_table.hpp"
+#include "engine/search_position.hpp"
+#include "engine/value_tables.hpp"
+
+// Tuned tables, in the order they are added in the constructor
+enum Table : size_t {
+    PieceValues, BishopPair, KnightPair, KnightOutpost, RookFile, Mobility, KingPawnShield, AttackValues,
+    DefendedPawn, DoubledPawn, TripledPawn, BackwardPawn, IsolatedPawn, PassedPawn, BlockedPassedPawn,
+    PstKnight, PstBishop, PstRook, PstQueen, PstKing, PstPawn
+};
+
+// Piece-square table of each piece type
+static constexpr Table PST_TABLES[6] = {PstKnight, PstBishop, PstRook, PstQueen, PstKing, PstPawn};
+
+static constexpr double ADAM_BETA1 = 0.9;
+static constexpr double ADAM_BETA2 = 0.999;
+static constexpr double ADAM_EPSILON = 1e-8;
+
+static double sigmoid(double k, double eval) {
+    return 1.0 / (1.0 + std::exp(-k * eval / 400.0));
+}
+
+bool parse_epd_line(const std::string& line, FEN& fen, double& result) {
+    std::istringstream iss(line);
+    std::string fields[4];
+    for (std::string& field : fields)
+        if (!(iss >> field)) return false;
+    fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+
+    // Result anywhere after the position fields
+    const std::string rest = line.substr(std::min(line.size(), static_cast<size_t>(iss.tellg())));
+    static const std::pair<const char*, double> LABELS[] = {
+        {"1/2-1/2", 0.5}, {"1-0", 1.0}, {"0-1", 0.0}, {"[0.5]", 0.5}, {"[1.0]", 1.0}, {"[0.0]", 0.0}, {"[1]", 1.0}, {"[0]", 0.0}
+    };
+    for (const auto& [label, value] : LABELS) {
+        if (rest.find(label) != std::string::npos) {
+            result = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Capture-only quiescence search that records the principal variation, used to reach a quiet position.
+ */
+class QuietResolver {
+public:
+    static constexpr int32_t MATE = 30000;
+    static constexpr int MAX_PLY = 32;
+
+    QuietResolver() : m_spos(1) {}
+
+    /**
+     * Play the quiescence search principal variation of a position.
+     * @param fen the position
+     * @return False if the position is mate or the search ends in a mate.
+     */
+    bool resolve(const FEN& fen) {
+        m_spos.set_board(fen);
+        const int32_t score = _search(-MATE, MATE, 0);
+        if (std::abs(score) >= MATE - MAX_PLY)
+            return false;
+        for (int i = 0; i < m_pv_length[0]; ++i)
+            m_spos.make_move(m_pv[0][i]);
+        return true;
+    }
+
+    const Position& position() const { return m_spos.get_position(); }
+
+private:
+    int32_t _search(int32_t alpha, int32_t beta, int ply) {
+        m_pv_length[ply] = 0;
+        const Position& position = m_spos.get_position();
+        if (ply >= MAX_PLY - 1)
+            return m_spos.get_eval();
+
+        MoveList moves;
+        const bool in_check = position.in_check();
+        if (in_check) {
+            moves.generate<GenerateType::Evasions>(position);
+            if (moves.count() == 0)
+                return -MATE + ply;
+        }
+        else {
+            const int32_t stand_pat = m_spos.get_eval();
+            if (stand_pat >= beta)
+                return stand_pat;
+            alpha = std::max(alpha, stand_pat);
+            moves.generate<GenerateType::Captures>(position);
+        }
+
+        // Most valuable victim first
+        auto victim_value = [&](Move move) {
+            const Piece captured = position.get_piece_at(MoveEncoding::to_sq(move));
+            return captured == Piece::None ? 0 : PIECE_VALUES[+to_type(captured)];
+        };
+        std::sort(moves.begin(), moves.end(), [&](Move a, Move b) { return victim_value(a) > victim_value(b); });
+
+        for (Move move : moves) {
+            m_spos.make_move(move);
+            const int32_t score = -_search(-beta, -alpha, ply + 1);
+            m_spos.undo_move();
+
+            if (score > alpha) {
+                alpha = score;
+                m_pv[ply][0] = move;
+                std::copy(m_pv[ply + 1], m_pv[ply + 1] + m_pv_length[ply + 1], m_pv[ply] + 1);
+                m_pv_length[ply] = m_pv_length[ply + 1] + 1;
+                if (alpha >= beta)
+                    break;
+            }
+        }
+        return alpha;
+    }
+
+    SearchPosition m_spos;
+    Move m_pv[MAX_PLY][MAX_PLY];
+    int m_pv_length[MAX_PLY];
+};
+
+TexelTuner::TexelTuner(const TexelTunerConfig& config)
+  : m_config(config), m_k(config.k)
+{
+    auto add_table = [&](const char* name, const int32_t* values, size_t count) {
+        m_tables.push_back({name, std::vector<double>(values, values + count), std::vector<bool>(count, true)});
+    };
+    add_table("PIECE_VALUES", PIECE_VALUES, 8);
+    add_table("BISHOP_PAIR_VALUE", BISHOP_PAIR_VALUE, 2);
+    add_table("KNIGHT_PAIR_VALUE", KNIGHT_PAIR_VALUE, 2);
+    add_table("KNIGHT_OUTPOST_VALUE", KNIGHT_OUTPOST_VALUE, 2);
+    add_table("ROOK_FILE_VALUES", &ROOK_FILE_VALUES[0][0], 4);
+    add_table("MOBILITY_VALUES", &MOBILITY_VALUES[0][0], 8);
+    add_table("KING_PAWN_SHIELD_VALUES", KING_PAWN_SHIELD_VALUES, 2);
+    add_table("ATTACK_VALUES", &ATTACK_VALUES[0][0], 8);
+    add_table("DEFENDED_PAWN_VALUE", &DEFENDED_PAWN_VALUE, 1);
+    add_table("DOUBLED_PAWN_VALUE", &DOUBLED_PAWN_VALUE, 1);
+    add_table("TRIPLED_PAWN_VALUE", &TRIPLED_PAWN_VALUE, 1);
+    add_table("BACKWARD_PAWN_VALUE", &BACKWARD_PAWN_VALUE, 1);
+    add_table("ISOLATED_PAWN_VALUES", ISOLATED_PAWN_VALUES, 8);
+    add_table("PASSED_PAWN_VALUES", PASSED_PAWN_VALUES, 8);
+    add_table("BLOCKED_PASSED_PAWN_VALUE", BLOCKED_PASSED_PAWN_VALUE, 2);
+    add_table("PST_KNIGHT", &PST_KNIGHT[0][0], 128);
+    add_table("PST_BISHOP", &PST_BISHOP[0][0], 128);
+    add_table("PST_ROOK", &PST_ROOK[0][0], 128);
+    add_table("PST_QUEEN", &PST_QUEEN[0][0], 128);
+    add_table("PST_KING", &PST_KING[0][0], 128);
+    add_table("PST_PAWN", &PST_PAWN[0][0], 128);
+
+    // The king value cancels out, All and None are placeholders
+    for (PieceType type : {PieceType::King, PieceType::All, PieceType::None})
+        m_tables[PieceValues].tuned[+type] = false;
+
+    for (const TunedTable& table : m_tables) {
+        m_offsets.push_back(m_parameters.size());
+        m_parameters.insert(m_parameters.end(), table.values.begin(), table.values.end());
+        m_tuned.insert(m_tuned.end(), table.tuned.begin(), table.tuned.end());
+    }
+}
+
+void TexelTuner::_coefficients(const Position& position, std::vector<std::pair<uint16_t, float>>& coefficients) const {
+    // Per-parameter counts of the middlegame, endgame and unphased (pawn structure) parts, from white's perspective
+    const size_t parameter_count = m_parameters.size();
+    std::vector<double> counts(3 * parameter_count, 0.0);
+    double* mg = counts.data();
+    double* eg = mg + parameter_count;
+    double* direct = eg + parameter_count;
+    auto param = [&](Table table, size_t index) { return m_offsets[table] + index; };
+    auto add_phased = [&](Table table, size_t mg_index, size_t eg_index, double count) {
+        mg[param(table, mg_index)] += count;
+        eg[param(table, eg_index)] += count;
+    };
+
+    // Material and piece-square tables
+    for (int sq = 0; sq < 64; ++sq) {
+        const Piece piece = position.get_piece_at(static_cast<Square>(sq));
+        if (piece == Piece::None) continue;
+        const Color color = to_color(piece);
+        const int type = +to_type(piece);
+        const double sign = color == Color::White ? 1.0 : -1.0;
+        const int idx = +square_for_side(static_cast<Square>(sq), color);
+        add_phased(PieceValues, type, type, sign);
+        add_phased(PST_TABLES[type], idx, 64 + idx, sign);
+    }
+
+    // Material imbalance
+    for (Color color : {Color::White, Color::Black}) {
+        const double sign = color == Color::White ? 1.0 : -1.0;
+        if (popcount(position.get_pieces(color, PieceType::Bishop)) >= 2)
+            add_phased(BishopPair, 0, 1, sign);
+        if (popcount(position.get_pieces(color, PieceType::Knight)) >= 2)
+            add_phased(KnightPair, 0, 1, sign);
+    }
+
+    // Pawn sets shared with the engine's pawn hash entries
+    const Bitboard w_pawns = position.get_pieces(Color::White, PieceType::Pawn);
+    const Bitboard b_pawns = position.get_pieces(Color::Black, PieceType::Pawn);
+    const PawnTableEntry pawn_sets = compute_pawn_sets(w_pawns, b_pawns);
+    const Bitboard w_attacks = pawn_sets.pawn_attacks[+Color::White];
+    const Bitboard b_attacks = pawn_sets.pawn_attacks[+Color::Black];
+
+    // Knight outposts
+    constexpr Bitboard CENTRAL_SQUARES = 0x0000001818000000ULL;
+    const Bitboard w_outposts = position.get_pieces(Color::White, PieceType::Knight) & CENTRAL_SQUARES & w_attacks
+                                & ~pawn_sets.attack_spans[+Color::Black];
+    const Bitboard b_outposts = position.get_pieces(Color::Black, PieceType::Knight) & CENTRAL_SQUARES & b_attacks
+                                & ~pawn_sets.attack_spans[+Color::White];
+    add_phased(KnightOutpost, 0, 1, popcount(w_outposts) - popcount(b_outposts));
+
+    // Blocked passed pawns
+    const Bitboard occupied = position.get_pieces();
+    add_phased(BlockedPassedPawn, 0, 1, popcount(shift_bb<Shift::Up>(pawn_sets.passed_pawns[+Color::White]) & occupied)
+                                        - popcount(shift_bb<Shift::Down>(pawn_sets.passed_pawns[+Color::Black]) & occupied));
+
+    // Rooks on semi-open and open files
+    for (Color side : {Color::White, Color::Black}) {
+        const double sign = side == Color::White ? 1.0 : -1.0;
+        const uint8_t semi_open_files = pawn_sets.semi_open_files[+side];
+        const uint8_t open_files = semi_open_files & pawn_sets.semi_open_files[+opponent(side)];
+        for (Bitboard rooks = position.get_pieces(side, PieceType::Rook); rooks; pop_lsb(rooks)) {
+            const int file = file_of(lsb(rooks));
+            if ((semi_open_files >> file) & 1) {
+                const int open = (open_files >> file) & 1;
+                add_phased(RookFile, open * 2, open * 2 + 1, sign);
+            }
+        }
+    }
+
+    // Mobility, king zone attacks and pawn shield
+    for (Color side : {Color::White, Color::Black}) {
+        const double sign = side == Color::White ? 1.0 : -1.0;
+        const Bitboard mobility_area = ~position.get_pieces(side);
+
+        const Square opp_king_square = lsb(position.get_pieces(opponent(side), PieceType::King));
+        Bitboard opp_king_zone = MASK_KING_ATTACKS[+opp_king_square] | MASK_SQUARE[+opp_king_square];
+        opp_king_zone |= side == Color::White ? shift_bb<Shift::DoubleDown>(opp_king_zone) : shift_bb<Shift::DoubleUp>(opp_king_zone);
+        opp_king_zone &= mobility_area;
+
+        const Square king_square = lsb(position.get_pieces(side, PieceType::King));
+        const Bitboard king_attacks = MASK_KING_ATTACKS[+king_square];
+        const Bitboard shield_squares = side == Color::White ? shift_bb<Shift::Up>(king_attacks) : shift_bb<Shift::Down>(king_attacks);
+        add_phased(KingPawnShield, 0, 1, sign * popcount(shield_squares & position.get_pieces(side, PieceType::Pawn)));
+
+        int32_t zone_attacks[4] = {0, 0, 0, 0};
+        int32_t attack_count = 0;
+        for (PieceType type : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+            Bitboard pieces = position.get_pieces(side, type);
+            while (pieces) {
+                const Square square = lsb(pieces);
+                Bitboard attacks;
+                switch (type) {
+                    case PieceType::Knight: attacks = attacks_from<PieceType::Knight>(square, occupied); break;
+                    case PieceType::Bishop: attacks = attacks_from<PieceType::Bishop>(square, occupied); break;
+                    case PieceType::Rook:   attacks = attacks_from<PieceType::Rook>(square, occupied); break;
+                    default:                attacks = attacks_from<PieceType::Queen>(square, occupied); break;
+                }
+                const int32_t attacked = popcount(attacks & opp_king_zone);
+                add_phased(Mobility, +type * 2, +type * 2 + 1, sign * popcount(attacks & mobility_area));
+                zone_attacks[+type] += attacked;
+                attack_count += attacked > 0;
+                pop_lsb(pieces);
+            }
+        }
+        const double multiplier = ATTACK_COUNT_MULTIPLIER[std::min(attack_count, 6)] / 100.0;
+        for (int type = 0; type < 4; ++type)
+            add_phased(AttackValues, type * 2, type * 2 + 1, sign * zone_attacks[type] * multiplier);
+    }
+
+    // Pawn structure, not interpolated by phase
+    for (Color side : {Color::White, Color::Black}) {
+        const double sign = side == Color::White ? 1.0 : -1.0;
+        const bool white = side == Color::White;
+        const Bitboard pawns = white ? w_pawns : b_pawns;
+
+        const Bitboard behind_own = pawns & (white ? front_spans<Color::Black>(pawns) : front_spans<Color::White>(pawns));
+        const Bitboard ahead_own = pawns & (white ? front_spans<Color::White>(pawns) : front_spans<Color::Black>(pawns));
+        direct[param(DoubledPawn, 0)] += sign * popcount(behind_own);
+        direct[param(TripledPawn, 0)] += sign * popcount(behind_own & ahead_own);
+
+        Bitboard isolated = pawns & ~left_attack_file_fills(pawns) & ~right_attack_file_fills(pawns);
+        for (; isolated; pop_lsb(isolated))
+            direct[param(IsolatedPawn, white ? file_of(lsb(isolated)) : 7 - file_of(lsb(isolated)))] += sign;
+
+        Bitboard passed = pawn_sets.passed_pawns[+side];
+        for (; passed; pop_lsb(passed))
+            direct[param(PassedPawn, white ? rank_of(lsb(passed)) : 7 - rank_of(lsb(passed)))] += sign;
+
+        const Bitboard other_attacks = white ? b_attacks : w_attacks;
+        const Bitboard controlled_stops = other_attacks & ~pawn_sets.attack_spans[+side];
+        const Bitboard backward = pawns & (white ? rear_spans<Color::White>(controlled_stops) : rear_spans<Color::Black>(controlled_stops));
+        direct[param(BackwardPawn, 0)] += sign * popcount(backward);
+        direct[param(DefendedPawn, 0)] += sign * popcount(pawns & (white ? w_attacks : b_attacks));
+    }
+
+    // Game phase
+    int32_t phase = 0;
+    for (int type = 0; type < 6; ++type)
+        phase += popcount(position.get_pieces(PieceType(type))) * MATERIAL_WEIGHTS[type];
+    phase = std::max(std::min(phase, PHASE_MAX) - PHASE_MIN, 0);
+
+    // Endgame scale factor of the side ahead in the endgame part
+    double eg_eval = 0.0;
+    for (size_t i = 0; i < parameter_count; ++i)
+        eg_eval += eg[i] * m_parameters[i];
+    const Color strong_side = eg_eval > 0 ? Color::White : Color::Black;
+    auto non_pawn_material = [&](Color color) {
+        double material = 0.0;
+        for (PieceType type : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen})
+            material += popcount(position.get_pieces(color, type)) * m_parameters[param(PieceValues, +type)];
+        return material;
+    };
+    const double own = non_pawn_material(strong_side);
+    const double other = non_pawn_material(opponent(strong_side));
+    const double bishop_value = m_parameters[param(PieceValues, +PieceType::Bishop)];
+    const double rook_value = m_parameters[param(PieceValues, +PieceType::Rook)];
+    double scale_factor = SCALE_FACTOR_NORMAL;
+    if (position.get_pieces(strong_side, PieceType::Pawn) == 0 && own - other <= bishop_value)
+        scale_factor = own < rook_value ? 0 : other <= bishop_value ? 4 : 14;
+
+    const double mg_weight = static_cast<double>(phase) / PHASE_WIDTH;
+    const double eg_weight = static_cast<double>(PHASE_WIDTH - phase) / PHASE_WIDTH * scale_factor / SCALE_FACTOR_NORMAL;
+
+    coefficients.clear();
+    for (size_t i = 0; i < parameter_count; ++i) {
+        const double coefficient = mg[i] * mg_weight + eg[i] * eg_weight + direct[i];
+        if (coefficient != 0.0)
+            coefficients.emplace_back(static_cast<uint16_t>(i), static_cast<float>(coefficient));
+    }
+}
+
+void TexelTuner::add_position(const Position& position, double result) {
+    std::vector<std::pair<uint16_t, float>> coefficients;
+    _coefficients(position, coefficients);
+    m_entries.push_back({static_cast<uint32_t>(m_indices.size()), static_cast<uint16_t>(coefficients.size()), static_cast<float>(result)});
+    for (const auto& [index, value] : coefficients) {
+        m_indices.push_back(index);
+        m_values.push_back(value);
+    }
+}
+
+size_t TexelTuner::load_epd(const std::string& path, size_t limit) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("TexelTuner::load_epd() - cannot open file: " + path);
+
+    std::vector<std::pair<FEN, double>> labelled;
+    std::string line;
+    FEN fen;
+    double result;
+    while (labelled.size() < limit && std::getline(file, line))
+        if (parse_epd_line(line, fen, result))
+            labelled.emplace_back(fen, result);
+
+    // Resolve and extract coefficients in parallel, each thread into its own arrays
+    struct Partial {
+        std::vector<Entry> entries;
+        std::vector<uint16_t> indices;
+        std::vector<float> values;
+    };
+    const size_t thread_count = std::clamp<size_t>(labelled.size() / 1024, 1, std::max(1, m_config.threads));
+    std::vector<Partial> partials(thread_count);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&, t] {
+            Partial& partial = partials[t];
+            QuietResolver resolver;
+            std::vector<std::pair<uint16_t, float>> coefficients;
+            for (size_t i = t; i < labelled.size(); i += thread_count) {
+                try {
+                    if (!resolver.resolve(labelled[i].first)) continue;
+                }
+                catch (const std::invalid_argument&) { // invalid FEN
+                    continue;
+                }
+                _coefficients(resolver.position(), coefficients);
+                partial.entries.push_back({static_cast<uint32_t>(partial.indices.size()), static_cast<uint16_t>(coefficients.size()),
+                                           static_cast<float>(labelled[i].second)});
+                for (const auto& [index, value] : coefficients) {
+                    partial.indices.push_back(index);
+                    partial.values.push_back(value);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+
+    const size_t loaded_before = m_entries.size();
+    for (const Partial& partial : partials) {
+        const uint32_t base = static_cast<uint32_t>(m_indices.size());
+        for (Entry entry : partial.entries) {
+            entry.begin += base;
+            m_entries.push_back(entry);
+        }
+        m_indices.insert(m_indices.end(), partial.indices.begin(), partial.indices.end());
+        m_values.insert(m_values.end(), partial.values.begin(), partial.values.end());
+    }
+    return m_entries.size() - loaded_before;
+}
+
+size_t TexelTuner::position_count() const {
+    return m_entries.size();
+}
+
+double TexelTuner::_linear_eval(const Entry& entry) const {
+    double eval = 0.0;
+    for (uint32_t i = entry.begin; i < entry.begin + entry.count; ++i)
+        eval += m_values[i] * m_parameters[m_indices[i]];
+    return eval;
+}
+
+template<typename Function>
+double TexelTuner::_parallel_sum(Function&& function) const {
+    const size_t thread_count = std::clamp<size_t>(m_entries.size() / 4096, 1, std::max(1, m_config.threads));
+    const size_t per_thread = (m_entries.size() + thread_count - 1) / thread_count;
+    std::vector<double> sums(thread_count, 0.0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        const size_t begin = std::min(m_entries.size(), t * per_thread);
+        const size_t end = std::min(m_entries.size(), begin + per_thread);
+        workers.emplace_back([&, t, begin, end] { sums[t] = function(t, begin, end); });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+
+    double sum = 0.0;
+    for (double s : sums) sum += s;
+    return sum;
+}
+
+double TexelTuner::loss() const {
+    if (m_entries.empty()) return 0.0;
+    const double k = m_k > 0.0 ? m_k : 1.0;
+    const double error = _parallel_sum([&](size_t, size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const double diff = m_entries[i].result - sigmoid(k, _linear_eval(m_entries[i]));
+            sum += diff * diff;
+        }
+        return sum;
+    });
+    return error / static_cast<double>(m_entries.size());
+}
+
+double TexelTuner::fit_scaling_constant() {
+    // Golden section search, the loss is unimodal in k
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double low = 0.05, high = 5.0;
+    for (int i = 0; i < 40; ++i) {
+        const double a = high - ratio * (high - low);
+        const double b = low + ratio * (high - low);
+        m_k = a;
+        const double loss_a = loss();
+        m_k = b;
+        const double loss_b = loss();
+        if (loss_a < loss_b) high = b;
+        else low = a;
+    }
+    m_k = (low + high) / 2.0;
+    return m_k;
+}
+
+void TexelTuner::tune() {
+    if (m_entries.empty()) return;
+    if (m_k <= 0.0)
+        fit_scaling_constant();
+    std::cout << "Tuning " << m_parameters.size() << " weights on " << m_entries.size()
+              << " positions, k = " << m_k << ", initial loss " << loss() << std::endl;
+
+    const size_t parameter_count = m_parameters.size();
+    const size_t max_threads = static_cast<size_t>(std::max(1, m_config.threads));
+    std::vector<std::vector<double>> gradients(max_threads, std::vector<double>(parameter_count));
+    std::vector<double> moment1(parameter_count, 0.0), moment2(parameter_count, 0.0);
+
+    for (int iteration = 1; iteration <= m_config.iterations; ++iteration) {
+        // Gradient of the mean squared error, accumulated per thread
+        const double error = _parallel_sum([&](size_t t, size_t begin, size_t end) {
+            std::vector<double>& gradient = gradients[t];
+            std::fill(gradient.begin(), gradient.end(), 0.0);
+            double sum = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                const Entry& entry = m_entries[i];
+                const double s = sigmoid(m_k, _linear_eval(entry));
+                const double diff = entry.result - s;
+                sum += diff * diff;
+                const double factor = -2.0 * diff * s * (1.0 - s) * m_k / 400.0;
+                for (uint32_t j = entry.begin; j < entry.begin + entry.count; ++j)
+                    gradient[m_indices[j]] += factor * m_values[j];
+            }
+            return sum;
+        });
+
+        const double correction1 = 1.0 - std::pow(ADAM_BETA1, iteration);
+        const double correction2 = 1.0 - std::pow(ADAM_BETA2, iteration);
+        for (size_t i = 0; i < parameter_count; ++i) {
+            if (!m_tuned[i]) continue;
+            double g = 0.0;
+            for (const std::vector<double>& gradient : gradients)
+                g += gradient[i];
+            g /= static_cast<double>(m_entries.size());
+
+            moment1[i] = ADAM_BETA1 * moment1[i] + (1.0 - ADAM_BETA1) * g;
+            moment2[i] = ADAM_BETA2 * moment2[i] + (1.0 - ADAM_BETA2) * g * g;
+            m_parameters[i] -= m_config.learning_rate * (moment1[i] / correction1)
+                             / (std::sqrt(moment2[i] / correction2) + ADAM_EPSILON);
+        }
+
+        if (iteration % m_config.report_interval == 0 || iteration == m_config.iterations)
+            std::cout << "iteration " << iteration << " loss " << error / static_cast<double>(m_entries.size()) << std::endl;
+    }
+
+    // Write the weights back to the tables
+    for (size_t table = 0; table < m_tables.size(); ++table)
+        std::copy_n(m_parameters.begin() + m_offsets[table], m_tables[table].values.size(), m_tables[table].values.begin());
+}
+
+double TexelTuner::evaluate(const Position& position) const {
+    std::vector<std::pair<uint16_t, float>> coefficients;
+    _coefficients(position, coefficients);
+    double eval = 0.0;
+    for (const auto& [index, value] : coefficients)
+        eval += value * m_parameters[index];
+    return eval;
+}
+
+const std::vector<TunedTable>& TexelTuner::tables() const {
+    return m_tables;
+}
+
+std::string TexelTuner::regenerate_header(const std::string& header_text) const {
+    std::string text = header_text;
+    for (const TunedTable& table : m_tables) {
+        std::smatch match;
+        const std::regex declaration("constexpr\\s+int32_t\\s+" + table.name + "\\b");
+        if (!std::regex_search(text, match, declaration))
+            throw std::runtime_error("TexelTuner::regenerate_header() - constant not found: " + table.name);
+
+        // Initializer from '=' to the terminating ';'
+        size_t pos = text.find('=', match.position(0) + match.length(0));
+        if (pos == std::string::npos)
+            throw std::runtime_error("TexelTuner::regenerate_header() - constant has no initializer: " + table.name);
+
+        std::string initializer;
+        size_t value_index = 0;
+        for (++pos; pos < text.size() && text[pos] != ';'; ) {
+            // Keep comments as is
+            if (text.compare(pos, 2, "//") == 0) {
+                const size_t line_end = text.find('\n', pos);
+                const size_t comment_end = line_end == std::string::npos ? text.size() : line_end;
+                initializer += text.substr(pos, comment_end - pos);
+                pos = comment_end;
+                continue;
+            }
+
+            // Replace integer literals, including a separated minus sign, keeping the width
+            size_t digits = pos;
+            if (text[pos] == '-')
+                for (digits = pos + 1; digits < text.size() && text[digits] == ' '; ++digits) {}
+            const bool identifier_char = pos > 0 && (std::isalnum(static_cast<unsigned char>(text[pos - 1])) || text[pos - 1] == '_');
+            if (digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits])) && !identifier_char) {
+                size_t end = digits;
+                while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) ++end;
+                if (value_index >= table.values.size())
+                    throw std::runtime_error("TexelTuner::regenerate_header() - too many values in: " + table.name);
+                std::string value = std::to_string(static_cast<int32_t>(std::lround(table.values[value_index++])));
+                if (value.size() < end - pos)
+                    value.insert(0, end - pos - value.size(), ' ');
+                initializer += value;
+                pos = end;
+                continue;
+            }
+            initializer += text[pos++];
+        }
+        if (value_index != table.values.size())
+            throw std::runtime_error("TexelTuner::regenerate_header() - value count mismatch in: " + table.name);
+
+        const size_t begin = text.find('=', match.position(0) + match.length(0)) + 1;
+        text.replace(begin, pos - begin, initializer);
+    }
+    return text;
+}
@@ -0,0 +1,83 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "trainer/nnue_trainer.hpp"
+
+static void print_usage() {
+    std::cout << "Usage:\n"
+              << "  nnue_trainer convert <input.txt> <output.bin>\n"
+              << "      Pack text lines '<fen> | <score cp, white> | <result 1.0/0.5/0.0>' into binary training data.\n"
+              << "  nnue_trainer train <data.bin> <output.nnue> [--epochs N] [--batch-size N] [--lr X]\n"
+              << "                     [--lr-decay X] [--lambda X] [--threads N] [--seed N]\n"
+              << "      Train a network on binary training data and write it in the format the engine loads.\n";
+}
+
+static int convert(const std::string& input_path, const std::string& output_path) {
+    std::ifstream input(input_path);
+    if (!input)
+        throw std::runtime_error("cannot open input file: " + input_path);
+    std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+    if (!output)
+        throw std::runtime_error("cannot open output file: " + output_path);
+
+    size_t written = 0, skipped = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.empty()) continue;
+        try {
+            const PackedPosition packed = parse_training_line(line);
+            output.write(reinterpret_cast<const char*>(&packed), sizeof(packed));
+            ++written;
+        }
+        catch (const std::invalid_argument&) {
+            ++skipped;
+        }
+    }
+    if (!output.flush())
+        throw std::runtime_error("failed to write output file: " + output_path);
+
+    std::cout << "Wrote " << written << " positions, skipped " << skipped << " invalid lines" << std::endl;
+    return 0;
+}
+
+static int train(int argc, char** argv) {
+    NnueTrainerConfig config;
+    config.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 4; i + 1 < argc; i += 2) {
+        const std::string option = argv[i];
+        const std::string value = argv[i + 1];
+        if (option == "--epochs") config.epochs = std::stoi(value);
+        else if (option == "--batch-size") config.batch_size = std::stoul(value);
+        else if (option == "--lr") config.learning_rate = std::stof(value);
+        else if (option == "--lr-decay") config.learning_rate_decay = std::stof(value);
+        else if (option == "--lambda") config.lambda = std::stof(value);
+        else if (option == "--threads") config.threads = std::stoi(value);
+        else if (option == "--seed") config.seed = std::stoull(value);
+        else throw std::invalid_argument("unknown option: " + option);
+    }
+    if ((argc - 4) % 2 != 0)
+        throw std::invalid_argument("missing value for option: " + std::string(argv[argc - 1]));
+
+    NnueTrainer trainer(config);
+    trainer.train(argv[2], argv[3]);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const std::string command = argc > 1 ? argv[1] : "";
+    try {
+        if (command == "convert" && argc == 4)
+            return convert(argv[2], argv[3]);
+        if (command == "train" && argc >= 4)
+            return train(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    print_usage();
+    return 1;
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include "trainer/texel_tuner.hpp"
+
+#ifndef VALUE_TABLES_PATH
+#define VALUE_TABLES_PATH "include/engine/value_tables.hpp"
+#endif
+
+static void print_usage() {
+    std::cout << "Usage:\n"
+              << "  tuner <data.epd> <output.hpp> [--iterations N] [--lr X] [--k X] [--threads N] [--limit N] [--template PATH]\n"
+              << "      Tune the evaluation weights on labelled EPD positions and write a regenerated value_tables.hpp.\n"
+              << "      The result is read from c9 \"1-0\", [1.0] or a bare 1-0 / 0-1 / 1/2-1/2 token on each line.\n"
+              << "      k is fitted to the data if not given. The template defaults to " << VALUE_TABLES_PATH << ".\n";
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("cannot open file: " + path);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (argc - 3) % 2 != 0) {
+        print_usage();
+        return 1;
+    }
+
+    try {
+        TexelTunerConfig config;
+        config.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        size_t limit = std::numeric_limits<size_t>::max();
+        std::string template_path = VALUE_TABLES_PATH;
+
+        for (int i = 3; i + 1 < argc; i += 2) {
+            const std::string option = argv[i];
+            const std::string value = argv[i + 1];
+            if (option == "--iterations") config.iterations = std::stoi(value);
+            else if (option == "--lr") config.learning_rate = std::stod(value);
+            else if (option == "--k") config.k = std::stod(value);
+            else if (option == "--threads") config.threads = std::stoi(value);
+            else if (option == "--limit") limit = std::stoull(value);
+            else if (option == "--template") template_path = value;
+            else throw std::invalid_argument("unknown option: " + option);
+        }
+
+        // Read the template first to fail early
+        const std::string header = read_file(template_path);
+
+        TexelTuner tuner(config);
+        const auto start = std::chrono::steady_clock::now();
+        const size_t loaded = tuner.load_epd(argv[1], limit);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Loaded " << loaded << " quiet positions in " << seconds << " s" << std::endl;
+
+        tuner.tune();
+
+        std::ofstream output(argv[2], std::ios::trunc);
+        output << tuner.regenerate_header(header);
+        if (!output.flush())
+            throw std::runtime_error("failed to write output file: " + std::string(argv[2]));
+        std::cout << "Wrote " << argv[2] << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,3 +1,5 @@
+#include <random>
+
 #include "gtest/gtest.h"
 #include "core/bitboard.hpp"
 
@@ -101,3 +103,38 @@ TEST(BitboardTests, BishopAttacks) {
     }
     EXPECT_EQ(MASK_BISHOP_ATTACKS[+Square::D4], expected);
 }
+
+// Table based reference for the shift based span and file fills
+static Bitboard table_fill(Bitboard bb, const Bitboard (&table)[64]) {
+    Bitboard fill = 0ULL;
+    while (bb) {
+        fill |= table[+lsb(bb)];
+        pop_lsb(bb);
+    }
+    return fill;
+}
+
+TEST(BitboardTests, SpanFillsMatchTables) {
+    std::mt19937_64 rng(1234);
+    for (int i = 0; i < 10000; i++) {
+        // Vary the density, pawn structures are sparse
+        Bitboard bb = rng();
+        if (i % 3 == 1) bb &= rng();
+        if (i % 3 == 2) bb &= rng() & rng();
+
+        EXPECT_EQ(front_spans<Color::White>(bb), table_fill(bb, FRONT_SPAN[+Color::White]));
+        EXPECT_EQ(front_spans<Color::Black>(bb), table_fill(bb, FRONT_SPAN[+Color::Black]));
+        EXPECT_EQ(rear_spans<Color::White>(bb), table_fill(bb, REAR_SPAN[+Color::White]));
+        EXPECT_EQ(rear_spans<Color::Black>(bb), table_fill(bb, REAR_SPAN[+Color::Black]));
+        EXPECT_EQ(left_attack_file_fills(bb), table_fill(bb, LEFT_ATTACK_FILE_FILL));
+        EXPECT_EQ(right_attack_file_fills(bb), table_fill(bb, RIGHT_ATTACK_FILE_FILL));
+    }
+
+    // Edge files and ranks
+    for (int square = 0; square < 64; square++) {
+        EXPECT_EQ(front_spans<Color::White>(MASK_SQUARE[square]), FRONT_SPAN[+Color::White][square]);
+        EXPECT_EQ(rear_spans<Color::Black>(MASK_SQUARE[square]), REAR_SPAN[+Color::Black][square]);
+        EXPECT_EQ(left_attack_file_fills(MASK_SQUARE[square]), LEFT_ATTACK_FILE_FILL[square]);
+        EXPECT_EQ(right_attack_file_fills(MASK_SQUARE[square]), RIGHT_ATTACK_FILE_FILL[square]);
+    }
+}
@@ -4,7 +4,7 @@
 #include "positions.hpp"
 
 // Helper function to test one case
-static inline int test_case(const FEN& fen, int expected_mate_in, int64_t node_limit) {
+static inline int test_case(const FEN& fen, int expected_mate_in, int64_t node_limit, int threads = 1) {
     const bool enable_output = false;
     const size_t tt_size_megabytes = 64ULL;
     const double time_limit_seconds = 300.0; // node limit should be the main limiter
@@ -12,6 +12,7 @@ static inline int test_case(const FEN& fen, int expected_mate_in, int64_t node_l
 
     auto engine = std::make_unique<MinimaxAI>(max_depth, time_limit_seconds, tt_size_megabytes, enable_output);
     engine->set_max_nodes(node_limit);
+    engine->set_threads(threads);
     engine->set_board(fen);
 
     auto[mate_distance, move] = engine->find_mate();
@@ -63,3 +64,11 @@ TEST(MateFinding, MateIn6Positions) {
     }
 }
 
+TEST(MateFinding, MateIn3PositionsMultiThreaded) {
+    const int64_t node_limit = 100'000; // limits main thread only
+    for (const auto& fen : MATE_IN_3) {
+        int mate_distance = test_case(fen, 3, node_limit, 4);
+        ASSERT_EQ(mate_distance, 3) << "FEN: " << fen << " expected mate in "
+                                    << 3 << " but got " << mate_distance;
+    }
+}
@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "core/memory.hpp"
+#include "core/bitboard.hpp"
+#include "core/numa.hpp"
+
+TEST(MemoryTests, LargePageArrayIsZeroedAndAligned) {
+    const size_t count = 3 * HUGE_PAGE_SIZE / sizeof(uint64_t) + 5; // not a multiple of the page size
+    LargePageArray<uint64_t> array(count);
+
+    ASSERT_EQ(array.size(), count);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(array.begin()) % 4096, 0U);
+    if (array.backing() != PageBacking::Normal) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(array.begin()) % HUGE_PAGE_SIZE, 0U);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(array[i], 0ULL);
+
+    // Whole range is writable
+    for (size_t i = 0; i < count; ++i)
+        array[i] = i;
+    EXPECT_EQ(array[count - 1], count - 1);
+}
+
+TEST(MemoryTests, LargePageArrayMove) {
+    LargePageArray<uint64_t> a(1024);
+    a[7] = 42;
+    const PageBacking backing = a.backing();
+
+    LargePageArray<uint64_t> b(std::move(a));
+    EXPECT_EQ(a.size(), 0U);
+    EXPECT_EQ(b.size(), 1024U);
+    EXPECT_EQ(b[7], 42ULL);
+    EXPECT_EQ(b.backing(), backing);
+
+    a = std::move(b);
+    EXPECT_EQ(a[7], 42ULL);
+}
+
+TEST(MemoryTests, RookAttackTableIsHugePageAligned) {
+#if defined(__linux__)
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ROOK_ATTACK_TABLE) % HUGE_PAGE_SIZE, 0U);
+#endif
+    EXPECT_EQ(sizeof(ROOK_ATTACK_TABLE), HUGE_PAGE_SIZE);
+}
+
+TEST(MemoryTests, NumaPlacementAndPinning) {
+    EXPECT_GE(numa_node_count(), 1U);
+
+    // Interleaving is only applied on multi-node systems, memory must stay usable either way
+    LargePageArray<uint64_t> array(HUGE_PAGE_SIZE / sizeof(uint64_t));
+    const bool interleaved = interleave_numa_nodes(array.begin(), array.size() * sizeof(uint64_t));
+    EXPECT_EQ(interleaved, numa_node_count() > 1);
+    array[array.size() - 1] = 1;
+    EXPECT_EQ(array[array.size() - 1], 1ULL);
+
+    // Any thread index maps to some allowed CPU
+    bool pinned = false;
+    std::thread([&] { pinned = pin_thread(12345); }).join();
+#if defined(__linux__)
+    EXPECT_TRUE(pinned);
+#endif
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "engine/nnue.hpp"
+#include "engine/search_position.hpp"
+#include "core/move_generation.hpp"
+#include "positions.hpp"
+
+static std::shared_ptr<NnueNetwork> random_network(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> feature_dist(-64, 64);
+    std::uniform_int_distribution<int> output_dist(-128, 128);
+
+    auto network = std::make_shared<NnueNetwork>();
+    for (auto& row : network->feature_weights)
+        for (int16_t& w : row) w = static_cast<int16_t>(feature_dist(rng));
+    for (int16_t& b : network->feature_biases) b = static_cast<int16_t>(feature_dist(rng) + 64);
+    for (auto& row : network->output_weights)
+        for (int16_t& w : row) w = static_cast<int16_t>(output_dist(rng));
+    network->output_bias = output_dist(rng) * NNUE_QA;
+    return network;
+}
+
+static std::string temp_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Straightforward float-free reference of the forward pass
+static int32_t reference_eval(const NnueNetwork& network, const Position& position) {
+    int64_t sum = network.output_bias;
+    const Color stm = position.get_side_to_move();
+    for (Color perspective : {stm, opponent(stm)}) {
+        int32_t hidden[NNUE_HIDDEN];
+        for (int i = 0; i < NNUE_HIDDEN; ++i) hidden[i] = network.feature_biases[i];
+        for (int sq = 0; sq < 64; ++sq) {
+            const Piece piece = position.get_piece_at(static_cast<Square>(sq));
+            if (piece == Piece::None) continue;
+            const int feature = nnue_feature_index(perspective, piece, static_cast<Square>(sq));
+            for (int i = 0; i < NNUE_HIDDEN; ++i) hidden[i] += network.feature_weights[feature][i];
+        }
+        const int output_row = perspective == stm ? 0 : 1;
+        for (int i = 0; i < NNUE_HIDDEN; ++i)
+            sum += std::clamp(hidden[i], 0, NNUE_QA) * network.output_weights[output_row][i];
+    }
+    return static_cast<int32_t>(sum * NNUE_EVAL_SCALE / (NNUE_QA * NNUE_QB));
+}
+
+TEST(NnueTests, SaveLoadRoundTrip) {
+    auto network = random_network(1);
+    const std::string path = temp_path("test_nnue_roundtrip.nnue");
+    network->save(path);
+    auto loaded = NnueNetwork::load(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(std::memcmp(network->feature_weights, loaded->feature_weights, sizeof(network->feature_weights)), 0);
+    EXPECT_EQ(std::memcmp(network->feature_biases, loaded->feature_biases, sizeof(network->feature_biases)), 0);
+    EXPECT_EQ(std::memcmp(network->output_weights, loaded->output_weights, sizeof(network->output_weights)), 0);
+    EXPECT_EQ(network->output_bias, loaded->output_bias);
+}
+
+TEST(NnueTests, LoadRejectsInvalidFiles) {
+    EXPECT_THROW(NnueNetwork::load(temp_path("test_nnue_does_not_exist.nnue")), std::runtime_error);
+
+    const std::string path = temp_path("test_nnue_invalid.nnue");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a network";
+    }
+    EXPECT_THROW(NnueNetwork::load(path), std::runtime_error);
+
+    // Corrupt one weight of a valid file
+    random_network(2)->save(path);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(1000);
+        file.put('\x7f');
+    }
+    EXPECT_THROW(NnueNetwork::load(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(NnueTests, EvaluateMatchesReference) {
+    auto network = random_network(3);
+    Position position;
+    NnueAccumulator accumulator;
+    for (const FEN& fen : TEST_POSITIONS) {
+        position.from_fen(fen);
+        network->refresh(accumulator, position);
+        ASSERT_EQ(network->evaluate(accumulator, position.get_side_to_move()), reference_eval(*network, position))
+            << "NNUE eval mismatch in position: " << fen;
+    }
+}
+
+TEST(NnueTests, IncrementalAccumulatorConsistency) {
+    std::shared_ptr<const NnueNetwork> network = random_network(4);
+    SearchPosition ss(1), rebuilt(1);
+    ss.set_nnue(network);
+    rebuilt.set_nnue(network);
+    MoveList move_list, replies;
+
+    for (const FEN& fen : TEST_POSITIONS) {
+        ss.set_board(fen);
+        const int32_t orig_eval = ss.get_eval();
+        ASSERT_EQ(orig_eval, reference_eval(*network, ss.get_position()));
+
+        move_list.generate<GenerateType::Legal>(ss.get_position());
+        for (Move move : move_list) {
+            ss.make_move(move);
+            rebuilt.set_board(ss.get_position().to_fen());
+            ASSERT_EQ(ss.get_eval(), rebuilt.get_eval()) << "NNUE eval mismatch after move in position: "
+                << fen << ", move: " << MoveEncoding::to_uci(move);
+
+            // One ply deeper covers updates from an incrementally updated accumulator
+            replies.generate<GenerateType::Legal>(ss.get_position());
+            if (replies.count() > 0) {
+                ss.make_move(*replies.begin());
+                rebuilt.set_board(ss.get_position().to_fen());
+                ASSERT_EQ(ss.get_eval(), rebuilt.get_eval());
+                ss.undo_move();
+            }
+
+            ss.undo_move();
+            ASSERT_EQ(ss.get_eval(), orig_eval) << "NNUE eval mismatch after undo in position: "
+                << fen << ", move: " << MoveEncoding::to_uci(move);
+        }
+    }
+}
+
+TEST(NnueTests, SwitchingNetworkMidGame) {
+    std::shared_ptr<const NnueNetwork> network = random_network(5);
+    SearchPosition ss(1), fresh(1);
+    ss.set_board(CHESS_START_POSITION);
+    MoveList move_list;
+    for (int i = 0; i < 4; ++i) {
+        move_list.generate<GenerateType::Legal>(ss.get_position());
+        ss.make_move(*move_list.begin());
+    }
+    const int32_t hand_crafted = ss.get_eval();
+
+    // Switching mid-game invalidates the earlier plies, which are refreshed on undo
+    ss.set_nnue(network);
+    fresh.set_nnue(network);
+    for (int i = 0; i < 4; ++i) {
+        ss.undo_move();
+        fresh.set_board(ss.get_position().to_fen());
+        ASSERT_EQ(ss.get_eval(), fresh.get_eval());
+    }
+
+    ss.set_nnue(nullptr);
+    for (int i = 0; i < 4; ++i) {
+        move_list.generate<GenerateType::Legal>(ss.get_position());
+        ss.make_move(*move_list.begin());
+    }
+    EXPECT_EQ(ss.get_eval(), hand_crafted);
+}
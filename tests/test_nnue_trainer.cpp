@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "trainer/nnue_trainer.hpp"
+#include "positions.hpp"
+
+TEST(NnueTrainerTests, PackedFeaturesMatchPosition) {
+    Position position;
+    for (const FEN& fen : TEST_POSITIONS) {
+        position.from_fen(fen);
+        const PackedPosition packed = pack_position(position, 0, RESULT_DRAW);
+        EXPECT_EQ(static_cast<Color>(packed.side_to_move), position.get_side_to_move());
+
+        for (Color perspective : {Color::White, Color::Black}) {
+            std::vector<int> expected;
+            for (int sq = 0; sq < 64; ++sq) {
+                const Piece piece = position.get_piece_at(static_cast<Square>(sq));
+                if (piece != Piece::None)
+                    expected.push_back(nnue_feature_index(perspective, piece, static_cast<Square>(sq)));
+            }
+            int features[32];
+            const int count = packed_features(packed, perspective, features);
+            ASSERT_EQ(std::vector<int>(features, features + count), expected) << "Feature mismatch in position: " << fen;
+        }
+    }
+}
+
+TEST(NnueTrainerTests, ParseTrainingLine) {
+    const PackedPosition packed = parse_training_line(std::string(CHESS_START_POSITION) + " | -35 | 0.5");
+    EXPECT_EQ(packed.score, -35);
+    EXPECT_EQ(packed.result, RESULT_DRAW);
+    EXPECT_EQ(parse_training_line(std::string(CHESS_START_POSITION) + " | 12 | 1.0").result, RESULT_WHITE_WIN);
+    EXPECT_EQ(parse_training_line(std::string(CHESS_START_POSITION) + " | 12 | 0").result, RESULT_BLACK_WIN);
+
+    EXPECT_THROW(parse_training_line(CHESS_START_POSITION), std::invalid_argument);
+    EXPECT_THROW(parse_training_line(std::string(CHESS_START_POSITION) + " | x | 1.0"), std::invalid_argument);
+    EXPECT_THROW(parse_training_line(std::string(CHESS_START_POSITION) + " | 10 | 0.7"), std::invalid_argument);
+    EXPECT_THROW(parse_training_line("not a fen | 10 | 1.0"), std::invalid_argument);
+}
+
+// Label each test position with a simple material count and check that the network learns it
+TEST(NnueTrainerTests, TrainingReducesLossAndQuantizes) {
+    std::vector<PackedPosition> data;
+    Position position;
+    for (const FEN& fen : TEST_POSITIONS) {
+        position.from_fen(fen);
+        int material = 0;
+        for (int sq = 0; sq < 64; ++sq) {
+            const Piece piece = position.get_piece_at(static_cast<Square>(sq));
+            if (piece == Piece::None || to_type(piece) == PieceType::King) continue;
+            static constexpr int VALUES[] = {300, 300, 500, 900, 0, 100};
+            material += to_color(piece) == Color::White ? VALUES[+to_type(piece)] : -VALUES[+to_type(piece)];
+        }
+        data.push_back(pack_position(position, static_cast<int16_t>(std::clamp(material, -2000, 2000)), RESULT_DRAW));
+    }
+
+    NnueTrainerConfig config;
+    config.learning_rate = 0.01f;
+    config.lambda = 1.0f;
+    config.threads = 2;
+    NnueTrainer trainer(config);
+
+    const double initial_loss = trainer.train_batch(data.data(), data.size());
+    double loss = initial_loss;
+    for (int step = 0; step < 200; ++step)
+        loss = trainer.train_batch(data.data(), data.size());
+    EXPECT_LT(loss, initial_loss * 0.5);
+
+    // The quantized network should evaluate close to the float network, up to a few percent of rounding error
+    const auto network = trainer.quantize();
+    NnueAccumulator accumulator;
+    for (size_t i = 0; i < data.size(); ++i) {
+        position.from_fen(TEST_POSITIONS[i]);
+        network->refresh(accumulator, position);
+        const int32_t quantized = network->evaluate(accumulator, position.get_side_to_move());
+        const float expected = trainer.evaluate(data[i]);
+        EXPECT_NEAR(quantized, expected, 10.0 + 0.05 * std::abs(expected)) << "Quantization error in position: " << TEST_POSITIONS[i];
+    }
+}
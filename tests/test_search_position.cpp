@@ -45,6 +45,59 @@ TEST(SearchPositionTests, MakeUndoConsistency) {
     }
 }
 
+TEST(SearchPositionTests, EvalCacheConsistency) {
+    SearchPosition ss;
+    MoveList move_list;
+
+    for (const FEN& fen : TEST_POSITIONS) {
+        ss.set_board(fen);
+        move_list.generate<GenerateType::Legal>(ss.get_position());
+
+        for (Move move : move_list) {
+            ss.make_move(move);
+            int32_t computed = ss.get_eval();
+            ss.reset_eval_cache_counters();
+            int32_t cached = ss.get_eval();
+            ASSERT_EQ(ss.get_eval_cache().hits(), 1ULL);
+            ASSERT_EQ(computed, cached) << "Cached eval mismatch after move in position: "
+                << fen << ", move: " << MoveEncoding::to_uci(move);
+
+            // a fresh cache must agree with the cached value
+            SearchPosition uncached(1);
+            uncached.set_board(ss.get_position().to_fen());
+            ASSERT_EQ(uncached.get_eval(), cached);
+            ASSERT_EQ(uncached.get_eval_cache().misses(), 1ULL);
+            ss.undo_move();
+        }
+    }
+}
+
+TEST(SearchPositionTests, StaticFeaturesToggle) {
+    SearchPosition ss;
+    MoveList move_list;
+    ss.set_board(CHESS_START_POSITION);
+    move_list.generate<GenerateType::Legal>(ss.get_position());
+
+    for (Move move : move_list) {
+        ss.make_move(move);
+
+        // King safety and mobility should stay small in the opening
+        ss.set_static_features(true);
+        int32_t with_features = ss.get_eval();
+        ss.set_static_features(false);
+        int32_t without_features = ss.get_eval();
+        EXPECT_LT(std::abs(with_features - without_features), 100) << "Static features too large after move: "
+            << MoveEncoding::to_uci(move);
+
+        // Toggling clears the cache, so the evaluations must match a fresh position
+        SearchPosition fresh(1);
+        fresh.set_board(ss.get_position().to_fen());
+        fresh.set_static_features(false);
+        EXPECT_EQ(fresh.get_eval(), without_features);
+        ss.undo_move();
+    }
+}
+
 // Flip/rotate the FEN 180 degrees and swap piece colors and side to move.
 // This produces the position seen from the opposite side such that a
 // symmetric eval should be equal for the side to move.
@@ -135,6 +188,16 @@ static std::string flip_fen_colors(const std::string& fen) {
     return new_board + " " + new_side + " " + new_castle + " " + new_ep + " " + half_fld + " " + full_fld;
 }
 
+TEST(SearchPositionTests, EvalFingerprint) {
+    SearchPosition a(1), b(1);
+    a.set_board(CHESS_START_POSITION);
+    b.set_board(COMPLEX_POSITION);
+    EXPECT_EQ(a.eval_fingerprint(), b.eval_fingerprint()); // depends on the evaluation only
+
+    b.set_static_features(false);
+    EXPECT_NE(a.eval_fingerprint(), b.eval_fingerprint());
+}
+
 TEST(SearchPositionTests, ColorFlippedEvalMatches) {
     SearchPosition ss, flipped;
     for (const FEN& fen : TEST_POSITIONS) {
@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include "trainer/spsa_tuner.hpp"
+#include "positions.hpp"
+
+TEST(SpsaTunerTests, SearchParametersRoundTrip) {
+    SearchParameters params;
+    params.set("futility_depth_margin", 120);
+    params.set("lmr_divisor", 250);
+    EXPECT_EQ(params.get("futility_depth_margin"), 120);
+    EXPECT_EQ(SearchParameters::parse(params.to_string()), params);
+    EXPECT_EQ(SearchParameters::parse("# comment\n\ndelta_margin 99\n").delta_margin, 99);
+
+    EXPECT_THROW(params.set("no_such_parameter", 1), std::invalid_argument);
+    EXPECT_THROW(params.set("lmr_divisor", 0), std::invalid_argument);
+    EXPECT_THROW(SearchParameters::parse("delta_margin"), std::invalid_argument);
+    EXPECT_THROW(SearchParameters::parse("delta_margin 10 20"), std::invalid_argument);
+}
+
+TEST(SpsaTunerTests, PlayGameEndings) {
+    MinimaxAI white(99, 1e6, 1, false), black(99, 1e6, 1, false);
+    white.set_max_nodes(2000);
+    black.set_max_nodes(2000);
+
+    // Mate in one for white, and bare kings
+    EXPECT_EQ(play_game(white, black, "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", 100), 1.0);
+    EXPECT_EQ(play_game(white, black, "8/8/4k3/8/8/3K4/8/8 w - - 0 1", 100), 0.5);
+    // Too short to finish
+    EXPECT_EQ(play_game(white, black, CHESS_START_POSITION, 2), 0.5);
+}
+
+TEST(SpsaTunerTests, StepIsDeterministicAndInRange) {
+    SpsaConfig config;
+    config.iterations = 10;
+    config.game_pairs = 2;
+    config.nodes_per_move = 1000;
+    config.max_plies = 30;
+    config.tt_size_megabytes = 1;
+    config.learning_rate = 0.05;
+
+    const std::vector<FEN> openings(std::begin(TEST_POSITIONS), std::begin(TEST_POSITIONS) + 8);
+    std::vector<double> values[2];
+    for (int threads : {1, 3}) {
+        config.threads = threads;
+        SpsaTuner tuner(config);
+        tuner.set_openings(openings);
+        for (int i = 0; i < 2; ++i) {
+            const SpsaResult result = tuner.step();
+            EXPECT_EQ(result.wins + result.draws + result.losses, 2 * config.game_pairs);
+        }
+        EXPECT_EQ(tuner.iteration(), 2);
+        values[threads == 1 ? 0 : 1] = tuner.values();
+
+        const auto& table = SearchParameters::table();
+        for (size_t i = 0; i < table.size(); ++i) {
+            EXPECT_GE(tuner.values()[i], table[i].min);
+            EXPECT_LE(tuner.values()[i], table[i].max);
+        }
+    }
+    EXPECT_EQ(values[0], values[1]);
+
+    SpsaTuner empty(config);
+    EXPECT_THROW(empty.step(), std::runtime_error);
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "trainer/texel_tuner.hpp"
+#include "engine/search_position.hpp"
+#include "core/move_generation.hpp"
+#include "positions.hpp"
+
+#ifndef VALUE_TABLES_PATH
+#define VALUE_TABLES_PATH "include/engine/value_tables.hpp"
+#endif
+
+TEST(TexelTunerTests, ParseEpdLine) {
+    FEN fen;
+    double result = -1.0;
+    ASSERT_TRUE(parse_epd_line("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - c9 \"1/2-1/2\";", fen, result));
+    EXPECT_EQ(fen, "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq -");
+    EXPECT_EQ(result, 0.5);
+    ASSERT_TRUE(parse_epd_line("8/8/8/8/8/8/8/K6k w - - [1.0]", fen, result));
+    EXPECT_EQ(result, 1.0);
+    ASSERT_TRUE(parse_epd_line("8/8/8/8/8/8/8/K6k w - - 0 1 0-1", fen, result));
+    EXPECT_EQ(result, 0.0);
+    EXPECT_FALSE(parse_epd_line("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq -;", fen, result));
+    EXPECT_FALSE(parse_epd_line("", fen, result));
+}
+
+// The linear model must reproduce the engine evaluation up to integer rounding
+TEST(TexelTunerTests, LinearEvalMatchesEngine) {
+    TexelTuner tuner(TexelTunerConfig{});
+    SearchPosition ss(1);
+    MoveList move_list;
+
+    auto expect_match = [&](const std::string& context) {
+        const Position& position = ss.get_position();
+        const int32_t engine_eval = position.get_side_to_move() == Color::White ? ss.get_eval() : -ss.get_eval();
+        ASSERT_NEAR(tuner.evaluate(position), engine_eval, 3.0) << "Linear eval mismatch in position: " << context;
+    };
+
+    for (const FEN& fen : TEST_POSITIONS) {
+        ss.set_board(fen);
+        expect_match(fen);
+        move_list.generate<GenerateType::Legal>(ss.get_position());
+        for (Move move : move_list) {
+            ss.make_move(move);
+            expect_match(ss.get_position().to_fen());
+            ss.undo_move();
+        }
+    }
+}
+
+TEST(TexelTunerTests, RegenerateHeaderKeepsLayout) {
+    std::ifstream file(VALUE_TABLES_PATH);
+    ASSERT_TRUE(file) << "Cannot open " << VALUE_TABLES_PATH;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string header = contents.str();
+
+    // Unchanged weights reproduce the header exactly
+    TexelTuner tuner(TexelTunerConfig{});
+    EXPECT_EQ(tuner.regenerate_header(header), header);
+
+    EXPECT_THROW(tuner.regenerate_header("constexpr int32_t PIECE_VALUES[2] = {1, 2};"), std::runtime_error);
+}
+
+TEST(TexelTunerTests, TuningReducesLoss) {
+    // Label the test positions by the sign of the current evaluation
+    TexelTunerConfig config;
+    config.iterations = 200;
+    config.learning_rate = 2.0;
+    config.k = 1.0;
+    config.threads = 2;
+    config.report_interval = 1000;
+    TexelTuner tuner(config);
+
+    Position position;
+    for (const FEN& fen : TEST_POSITIONS) {
+        position.from_fen(fen);
+        const double eval = tuner.evaluate(position);
+        tuner.add_position(position, eval > 100 ? 1.0 : eval < -100 ? 0.0 : 0.5);
+    }
+    ASSERT_EQ(tuner.position_count(), std::size(TEST_POSITIONS));
+
+    const double initial_loss = tuner.loss();
+    tuner.tune();
+    EXPECT_LT(tuner.loss(), initial_loss);
+}
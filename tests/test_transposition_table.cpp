@@ -0,0 +1,225 @@
+#include <random>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "engine/transposition_table.hpp"
+
+// Entry contents derived from the key, so that any mixed up entry can be detected
+static int16_t expected_score(uint64_t key) { return static_cast<int16_t>(static_cast<int32_t>(key >> 32) % 30'000); }
+static Move expected_move(uint64_t key) { return static_cast<Move>(key >> 8); }
+static int16_t expected_depth(uint64_t key) { return static_cast<int16_t>(key % 100); }
+static Bound expected_bound(uint64_t key) { return static_cast<Bound>(key % 3); }
+
+TEST(TranspositionTableTests, StoreAndFind) {
+    TranspositionTable tt(1);
+    const uint64_t key = 0x123456789ABCDEFULL;
+
+    EXPECT_FALSE(tt.find(key).has_value());
+
+    tt.store(key, -12345, 7, Bound::Lower, 0xBEEF);
+    auto entry = tt.find(key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->key, key);
+    EXPECT_EQ(entry->score, -12345);
+    EXPECT_EQ(entry->depth, 7);
+    EXPECT_EQ(entry->bound, Bound::Lower);
+    EXPECT_EQ(entry->best_move, 0xBEEF);
+    EXPECT_EQ(entry->eval, TT_EVAL_NONE);
+
+    // Overwrite same key
+    tt.store(key, 42, -1, Bound::Exact, NO_MOVE, -321);
+    entry = tt.find(key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->score, 42);
+    EXPECT_EQ(entry->depth, -1);
+    EXPECT_EQ(entry->bound, Bound::Exact);
+    EXPECT_EQ(entry->eval, -321);
+
+    // Out of range evals are clamped, never turning into TT_EVAL_NONE
+    tt.store(key, 0, 1, Bound::Exact, NO_MOVE, -100'000);
+    EXPECT_EQ(tt.find(key)->eval, TT_EVAL_NONE + 1);
+
+    tt.clear();
+    EXPECT_FALSE(tt.find(key).has_value());
+}
+
+TEST(TranspositionTableTests, ShallowStoreKeepsDeepEntry) {
+    TranspositionTable tt(1);
+    const uint64_t key = 0x123456789ABCDEFULL;
+
+    // A quiescence store does not replace a deep entry of the same search
+    tt.store(key, 100, 8, Bound::Lower, 0xBEEF, 20);
+    tt.store(key, -50, -1, Bound::Lower, NO_MOVE, 20);
+    auto entry = tt.find(key);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->score, 100);
+    EXPECT_EQ(entry->depth, 8);
+    EXPECT_EQ(entry->best_move, 0xBEEF);
+
+    // A slightly shallower store replaces it, keeping the move and eval when it has none
+    tt.store(key, 60, 6, Bound::Upper, NO_MOVE);
+    entry = tt.find(key);
+    EXPECT_EQ(entry->score, 60);
+    EXPECT_EQ(entry->depth, 6);
+    EXPECT_EQ(entry->best_move, 0xBEEF);
+    EXPECT_EQ(entry->eval, 20);
+
+    // Exact scores and entries from a previous search are always replaced
+    tt.store(key, 7, 0, Bound::Exact, NO_MOVE);
+    EXPECT_EQ(tt.find(key)->depth, 0);
+    tt.store(key, 100, 8, Bound::Lower, 0xBEEF);
+    tt.new_search_iteration();
+    tt.store(key, -50, -1, Bound::Lower, NO_MOVE);
+    EXPECT_EQ(tt.find(key)->depth, -1);
+}
+
+TEST(TranspositionTableTests, ClearAndWipe) {
+    TranspositionTable tt(1);
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> keys(1000);
+    for (uint64_t& key : keys)
+        key = rng() | 1ULL;
+
+    // Entries from before a clear are never found, and new entries can be stored over them
+    for (int round = 0; round < 3; ++round) {
+        for (uint64_t key : keys)
+            tt.store(key, expected_score(key), expected_depth(key), expected_bound(key), expected_move(key));
+        for (uint64_t key : keys)
+            ASSERT_TRUE(tt.find(key).has_value());
+
+        if (round % 2 == 0) tt.clear();
+        else tt.wipe(4);
+
+        for (uint64_t key : keys)
+            ASSERT_FALSE(tt.find(key).has_value());
+    }
+
+    tt.store(keys[0], 5, 3, Bound::Upper, 0x1234);
+    auto entry = tt.find(keys[0]);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->score, 5);
+    EXPECT_EQ(entry->best_move, 0x1234);
+}
+
+TEST(TranspositionTableTests, ConcurrentStoreAndFind) {
+    // Small table and a key pool much larger than the table, so that threads constantly
+    // overwrite each other's slots. Any torn entry that passes the key check would fail the checks below.
+    TranspositionTable tt(1);
+    const int thread_count = 8;
+    const int iterations = 200'000;
+
+    std::vector<uint64_t> keys(1 << 18);
+    std::mt19937_64 rng(42);
+    for (uint64_t& key : keys)
+        key = rng() | 1ULL; // non-zero
+
+    std::atomic<uint64_t> found{0};
+    std::atomic<uint64_t> corrupted{0};
+
+    auto worker = [&](int thread_index) {
+        std::mt19937_64 local_rng(thread_index);
+        for (int i = 0; i < iterations; ++i) {
+            const uint64_t key = keys[local_rng() % keys.size()];
+            if (local_rng() & 1) {
+                tt.store(key, expected_score(key), expected_depth(key), expected_bound(key), expected_move(key));
+            }
+            else if (auto entry = tt.find(key)) {
+                ++found;
+                if (entry->key != key
+                    || entry->score != expected_score(key)
+                    || entry->best_move != expected_move(key)
+                    || entry->depth != expected_depth(key)
+                    || entry->bound != expected_bound(key)) {
+                    ++corrupted;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t)
+        threads.emplace_back(worker, t);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_GT(found.load(), 0ULL);
+    EXPECT_EQ(corrupted.load(), 0ULL);
+}
+
+TEST(TranspositionTableTests, SaveAndLoad) {
+    const std::string path = (std::filesystem::temp_directory_path() / "chessbot_test_tt.bin").string();
+    std::mt19937_64 rng(11);
+    std::vector<uint64_t> keys(2000);
+    for (uint64_t& key : keys)
+        key = rng() | 1ULL;
+
+    TranspositionTable saved(2);
+    saved.clear(); // non-zero generation must survive the round trip
+    for (uint64_t key : keys)
+        saved.store(key, expected_score(key), expected_depth(key), expected_bound(key), expected_move(key));
+    saved.save(path);
+
+    // Loaded table takes the saved size
+    TranspositionTable loaded(1);
+    loaded.load(path);
+    EXPECT_EQ(loaded.page_backing(), PageBacking::MappedFile);
+    for (uint64_t key : keys) {
+        auto entry = loaded.find(key);
+        ASSERT_TRUE(entry.has_value());
+        EXPECT_EQ(entry->score, expected_score(key));
+        EXPECT_EQ(entry->best_move, expected_move(key));
+        EXPECT_EQ(entry->depth, expected_depth(key));
+        EXPECT_EQ(entry->bound, expected_bound(key));
+    }
+
+    // Stores go to private memory, clearing drops the file mapping
+    loaded.store(keys[0], 1, 1, Bound::Exact, NO_MOVE);
+    loaded.wipe();
+    EXPECT_FALSE(loaded.find(keys[1]).has_value());
+    loaded.load(path);
+    EXPECT_EQ(loaded.find(keys[0])->score, expected_score(keys[0]));
+
+    std::filesystem::remove(path);
+}
+
+TEST(TranspositionTableTests, LoadRejectsInvalidFiles) {
+    const std::string path = (std::filesystem::temp_directory_path() / "chessbot_test_tt_invalid.bin").string();
+    const uint64_t key = 0x123456789ABCDEFULL;
+
+    TranspositionTable tt(1);
+    tt.store(key, 77, 4, Bound::Exact, 0x4321);
+    tt.save(path);
+
+    // Corrupt one byte of the entries
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(4096 + (key & 0xFF) * 64);
+        file.put('\x5A');
+    }
+
+    TranspositionTable loaded(1);
+    loaded.store(key, 11, 4, Bound::Exact, NO_MOVE);
+    EXPECT_THROW(loaded.load(path), std::runtime_error);
+    EXPECT_EQ(loaded.find(key)->score, 11); // unchanged after a failed load
+    EXPECT_NO_THROW(loaded.load(path, /*verify_checksum=*/false));
+
+    // Saved under a different evaluation, the stored static evals would be stale
+    tt.save(path, /*eval_fingerprint=*/0x1234);
+    EXPECT_THROW(loaded.load(path), std::runtime_error);
+    EXPECT_THROW(loaded.load(path, true, 0x4321), std::runtime_error);
+    EXPECT_NO_THROW(loaded.load(path, true, 0x1234));
+
+    // Not a table file
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a transposition table";
+    }
+    EXPECT_THROW(loaded.load(path), std::runtime_error);
+    EXPECT_THROW(loaded.load(path + ".missing"), std::runtime_error);
+
+    std::filesystem::remove(path);
+}
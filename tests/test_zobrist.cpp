@@ -19,6 +19,7 @@ TEST(ZobristTests, IncrementalMakeUndoConsistency) {
         position.from_fen(fen);
         uint64_t orig_key = position.get_key();
         uint64_t orig_pawn_key = position.get_pawn_key();
+        uint64_t orig_material_key = position.get_material_key();
 
         move_list.generate<GenerateType::Legal>(position);
         ASSERT_FALSE(move_list.count() == 0) << "No legal moves in position: " << fen;
@@ -29,26 +30,52 @@ TEST(ZobristTests, IncrementalMakeUndoConsistency) {
             // check that rebuilding from FEN reproduces the same hashes
             uint64_t k1 = position.get_key();
             uint64_t pk1 = position.get_pawn_key();
+            uint64_t mk1 = position.get_material_key();
             rebuilt.from_fen(position.to_fen());
             uint64_t k2 = rebuilt.get_key();
             uint64_t pk2 = rebuilt.get_pawn_key();
+            uint64_t mk2 = rebuilt.get_material_key();
             ASSERT_EQ(k1, k2) << "Full hash mismatch after move in position: "
                 << fen << ", move: " << MoveEncoding::to_uci(move);
             ASSERT_EQ(pk1, pk2) << "Pawn hash mismatch after move in position: "
                 << fen << ", move: " << MoveEncoding::to_uci(move);
+            ASSERT_EQ(mk1, mk2) << "Material hash mismatch after move in position: "
+                << fen << ", move: " << MoveEncoding::to_uci(move);
 
             // Check eval matches after undo
             position.undo_move();
             uint64_t k3 = position.get_key();
             uint64_t pk3 = position.get_pawn_key();
+            uint64_t mk3 = position.get_material_key();
             ASSERT_EQ(orig_key, k3) << "Full hash mismatch after undo move in position: "
                 << fen << ", move: " << MoveEncoding::to_uci(move);
             ASSERT_EQ(orig_pawn_key, pk3) << "Pawn hash mismatch after undo move in position: "
                 << fen << ", move: " << MoveEncoding::to_uci(move);
+            ASSERT_EQ(orig_material_key, mk3) << "Material hash mismatch after undo move in position: "
+                << fen << ", move: " << MoveEncoding::to_uci(move);
         }
     } 
 }
 
+TEST(ZobristTests, KeyAfterMatchesMakeMove) {
+    Position position;
+
+    // Test that the predicted key matches the key after actually making the move
+    MoveList move_list;
+    for (const FEN& fen : TEST_POSITIONS) {
+        position.from_fen(fen);
+        move_list.generate<GenerateType::Legal>(position);
+
+        for (Move move : move_list) {
+            uint64_t predicted = position.key_after(move);
+            position.make_move(move);
+            ASSERT_EQ(predicted, position.get_key()) << "Predicted hash mismatch in position: "
+                << fen << ", move: " << MoveEncoding::to_uci(move);
+            position.undo_move();
+        }
+    }
+}
+
 TEST(ZobristTests, CollisionCheck) {
     rng.seed(42);
 